@@ -13,6 +13,7 @@ public class GitSourceControl : ModuleRules
 			new string[] {
 				"Core",
 				"CoreUObject",
+				"DirectoryWatcher",
 				"Slate",
 				"SlateCore",
 				"InputCore",
@@ -0,0 +1,369 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlCatFile.h"
+
+#include "GitSourceControlUtils.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeLock.h"
+
+namespace GitCatFileConstants
+{
+/** Maximum number of requests written to the process before reading back their responses (avoid filling both pipes) */
+const int32 MaxPipelinedRequests = 64;
+
+/** Maximum number of idle processes kept per repository and per mode */
+const int32 MaxIdleProcesses = 4;
+
+/** Maximum time to wait for a response of the process before giving up on it (in seconds) */
+const double ReadTimeout = 30.0;
+} // namespace GitCatFileConstants
+
+FGitCatFileProcess::FGitCatFileProcess(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode)
+	: Mode(InMode)
+{
+#if !UE_VERSION_OLDER_THAN(5, 0, 0)
+	FString FullCommand = FString::Printf(TEXT("-C \"%s\" cat-file "), *InRepositoryRoot);
+	switch (Mode)
+	{
+	case EGitCatFileMode::Check:
+		FullCommand += TEXT("--batch-check");
+		break;
+	default:
+		FullCommand += TEXT("--batch");
+		break;
+	}
+
+	const FString PathToGitOrEnvBinary = GitSourceControlUtils::GetGitLaunchExecutable(InPathToGitBinary, FullCommand);
+
+	if (!FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite))
+	{
+		return;
+	}
+	// The write end of the stdin pipe is kept by the Editor, the read end is inherited by the child process
+	if (!FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true))
+	{
+		return;
+	}
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("CatFileProcess: 'git %s'"), *FullCommand);
+
+	const bool bLaunchDetached = false;
+	const bool bLaunchHidden = true;
+	const bool bLaunchReallyHidden = bLaunchHidden;
+	ProcessHandle = FPlatformProcess::CreateProc(*PathToGitOrEnvBinary, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, *InRepositoryRoot, StdOutWrite, StdInRead);
+	bValid = ProcessHandle.IsValid();
+	if (!bValid)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to launch 'git cat-file'"));
+	}
+#endif
+}
+
+FGitCatFileProcess::~FGitCatFileProcess()
+{
+	Terminate();
+}
+
+bool FGitCatFileProcess::IsValid() const
+{
+	return bValid;
+}
+
+void FGitCatFileProcess::Terminate()
+{
+	bValid = false;
+
+	// Closing stdin makes the process exit on its own
+	if (StdInRead || StdInWrite)
+	{
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+		StdInRead = StdInWrite = nullptr;
+	}
+	if (ProcessHandle.IsValid())
+	{
+		for (int32 Retry = 0; (Retry < 50) && FPlatformProcess::IsProcRunning(ProcessHandle); ++Retry)
+		{
+			// Drain the output so that the process is never stuck writing a response nobody will read
+			TArray<uint8> Discarded;
+			FPlatformProcess::ReadPipeToArray(StdOutRead, Discarded);
+			FPlatformProcess::Sleep(0.001f);
+		}
+		if (FPlatformProcess::IsProcRunning(ProcessHandle))
+		{
+			FPlatformProcess::TerminateProc(ProcessHandle);
+		}
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+	if (StdOutRead || StdOutWrite)
+	{
+		FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+		StdOutRead = StdOutWrite = nullptr;
+	}
+}
+
+bool FGitCatFileProcess::GetObjectInfos(const TArray<FString>& InObjectNames, TArray<FGitObjectInfo>& OutInfos)
+{
+	check(Mode == EGitCatFileMode::Check);
+
+	OutInfos.Reset(InObjectNames.Num());
+	for (int32 First = 0; bValid && (First < InObjectNames.Num()); First += GitCatFileConstants::MaxPipelinedRequests)
+	{
+		const int32 Last = FMath::Min(First + GitCatFileConstants::MaxPipelinedRequests, InObjectNames.Num());
+		for (int32 Index = First; bValid && (Index < Last); ++Index)
+		{
+			WriteRequest(InObjectNames[Index]);
+		}
+		for (int32 Index = First; bValid && (Index < Last); ++Index)
+		{
+			ReadInfo(InObjectNames[Index], OutInfos.AddDefaulted_GetRef());
+		}
+	}
+
+	return bValid;
+}
+
+bool FGitCatFileProcess::ReadObject(const FString& InObjectName, FGitObjectInfo& OutInfo, TArray<uint8>& OutContent)
+{
+	check(Mode != EGitCatFileMode::Check);
+
+	OutContent.Reset();
+	if (WriteRequest(InObjectName) && ReadInfo(InObjectName, OutInfo) && OutInfo.IsValid())
+	{
+		// The content is followed by a newline
+		if (ReadBytes(OutInfo.Size + 1, OutContent))
+		{
+			OutContent.SetNum(OutInfo.Size, false);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FGitCatFileProcess::WriteRequest(const FString& InObjectName)
+{
+#if !UE_VERSION_OLDER_THAN(5, 0, 0)
+	if (bValid)
+	{
+		const FTCHARToUTF8 Request(*(InObjectName + TEXT("\n")));
+		int32 Written = 0;
+		bValid = FPlatformProcess::WritePipe(StdInWrite, reinterpret_cast<const uint8*>(Request.Get()), Request.Length(), &Written) && (Written == Request.Length());
+		if (!bValid)
+		{
+			UE_LOG(LogSourceControl, Warning, TEXT("CatFileProcess: failed to write request '%s'"), *InObjectName);
+		}
+	}
+#endif
+	return bValid;
+}
+
+bool FGitCatFileProcess::ReadInfo(const FString& InObjectName, FGitObjectInfo& OutInfo)
+{
+	// Either "<sha1> <type> <size>", or "<object> missing" (or "ambiguous")
+	FString Line;
+	if (!ReadLine(Line))
+	{
+		return false;
+	}
+
+	if (Line.EndsWith(TEXT(" missing")) || Line.EndsWith(TEXT(" ambiguous")))
+	{
+		return bValid;
+	}
+
+	TArray<FString> Fields;
+	Line.ParseIntoArray(Fields, TEXT(" "), true);
+	if ((Fields.Num() == 3) && (Fields[0].Len() >= 40) && Fields[2].IsNumeric())
+	{
+		OutInfo.Hash = MoveTemp(Fields[0]);
+		OutInfo.Type = MoveTemp(Fields[1]);
+		OutInfo.Size = FCString::Atoi64(*Fields[2]);
+	}
+	else
+	{
+		// Unexpected output: the protocol is out of sync, so this process cannot be used anymore
+		UE_LOG(LogSourceControl, Warning, TEXT("CatFileProcess: unexpected response '%s' for '%s'"), *Line, *InObjectName);
+		bValid = false;
+	}
+
+	return bValid;
+}
+
+bool FGitCatFileProcess::ReadLine(FString& OutLine)
+{
+	while (bValid)
+	{
+		for (int32 Index = BufferOffset; Index < Buffer.Num(); ++Index)
+		{
+			if (Buffer[Index] == '\n')
+			{
+				const FUTF8ToTCHAR Line(reinterpret_cast<const ANSICHAR*>(Buffer.GetData() + BufferOffset), Index - BufferOffset);
+				OutLine = FString(Line.Length(), Line.Get());
+				BufferOffset = Index + 1;
+				return true;
+			}
+		}
+		FillBuffer();
+	}
+
+	return false;
+}
+
+bool FGitCatFileProcess::ReadBytes(int64 InNumBytes, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset(InNumBytes);
+	while (bValid)
+	{
+		const int32 NumBytes = static_cast<int32>(FMath::Min<int64>(InNumBytes - OutBytes.Num(), Buffer.Num() - BufferOffset));
+		OutBytes.Append(Buffer.GetData() + BufferOffset, NumBytes);
+		BufferOffset += NumBytes;
+		if (OutBytes.Num() == InNumBytes)
+		{
+			return true;
+		}
+		FillBuffer();
+	}
+
+	return false;
+}
+
+bool FGitCatFileProcess::FillBuffer()
+{
+	// Compact the buffer before appending new data to it
+	if (BufferOffset > 0)
+	{
+		Buffer.RemoveAt(0, BufferOffset, false);
+		BufferOffset = 0;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (bValid)
+	{
+		TArray<uint8> Data;
+		if (FPlatformProcess::ReadPipeToArray(StdOutRead, Data) && (Data.Num() > 0))
+		{
+			Buffer.Append(MoveTemp(Data));
+			return true;
+		}
+		if (!FPlatformProcess::IsProcRunning(ProcessHandle))
+		{
+			// Read what the process could have written just before exiting
+			FPlatformProcess::ReadPipeToArray(StdOutRead, Data);
+			if (Data.Num() > 0)
+			{
+				Buffer.Append(MoveTemp(Data));
+				return true;
+			}
+			UE_LOG(LogSourceControl, Warning, TEXT("CatFileProcess: 'git cat-file' exited unexpectedly"));
+			bValid = false;
+		}
+		else if (FPlatformTime::Seconds() - StartTime > GitCatFileConstants::ReadTimeout)
+		{
+			// The process is stuck (or waiting for a request it did not understand): it is terminated when released
+			UE_LOG(LogSourceControl, Warning, TEXT("CatFileProcess: no response from 'git cat-file' after %.0f seconds"), GitCatFileConstants::ReadTimeout);
+			bValid = false;
+		}
+		else
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+
+	return false;
+}
+
+FGitCatFilePool& FGitCatFilePool::Get()
+{
+	static FGitCatFilePool Pool;
+	return Pool;
+}
+
+FString FGitCatFilePool::MakeKey(const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode)
+{
+	switch (InMode)
+	{
+	case EGitCatFileMode::Check: return InRepositoryRoot + TEXT("|check");
+	default: return InRepositoryRoot + TEXT("|batch");
+	}
+}
+
+TUniquePtr<FGitCatFileProcess> FGitCatFilePool::Acquire(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode)
+{
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (TArray<TUniquePtr<FGitCatFileProcess>>* Processes = IdleProcesses.Find(MakeKey(InRepositoryRoot, InMode)))
+		{
+			if (Processes->Num() > 0)
+			{
+				return Processes->Pop(false);
+			}
+		}
+	}
+
+	// Launch a new process outside of the lock
+	TUniquePtr<FGitCatFileProcess> Process = MakeUnique<FGitCatFileProcess>(InPathToGitBinary, InRepositoryRoot, InMode);
+	if (!Process->IsValid())
+	{
+		Process.Reset();
+	}
+	return Process;
+}
+
+void FGitCatFilePool::Release(const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode, TUniquePtr<FGitCatFileProcess>&& InProcess)
+{
+	if (InProcess.IsValid() && InProcess->IsValid())
+	{
+		FScopeLock Lock(&CriticalSection);
+		TArray<TUniquePtr<FGitCatFileProcess>>& Processes = IdleProcesses.FindOrAdd(MakeKey(InRepositoryRoot, InMode));
+		if (Processes.Num() < GitCatFileConstants::MaxIdleProcesses)
+		{
+			Processes.Add(MoveTemp(InProcess));
+		}
+	}
+	// else the process is destroyed (and terminated) here, outside of the lock
+	InProcess.Reset();
+}
+
+bool FGitCatFilePool::GetObjectInfos(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InObjectNames, TArray<FGitObjectInfo>& OutInfos)
+{
+	TUniquePtr<FGitCatFileProcess> Process = Acquire(InPathToGitBinary, InRepositoryRoot, EGitCatFileMode::Check);
+	if (!Process.IsValid())
+	{
+		return false;
+	}
+
+	const bool bResult = Process->GetObjectInfos(InObjectNames, OutInfos);
+	Release(InRepositoryRoot, EGitCatFileMode::Check, MoveTemp(Process));
+	return bResult;
+}
+
+bool FGitCatFilePool::ReadObject(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InObjectName, TArray<uint8>& OutContent)
+{
+	TUniquePtr<FGitCatFileProcess> Process = Acquire(InPathToGitBinary, InRepositoryRoot, EGitCatFileMode::Batch);
+	if (!Process.IsValid())
+	{
+		return false;
+	}
+
+	FGitObjectInfo Info;
+	const bool bResult = Process->ReadObject(InObjectName, Info, OutContent);
+	Release(InRepositoryRoot, EGitCatFileMode::Batch, MoveTemp(Process));
+	return bResult;
+}
+
+void FGitCatFilePool::Shutdown()
+{
+	TMap<FString, TArray<TUniquePtr<FGitCatFileProcess>>> Processes;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Processes = MoveTemp(IdleProcesses);
+		IdleProcesses.Reset();
+	}
+	// Processes are terminated when going out of scope
+}
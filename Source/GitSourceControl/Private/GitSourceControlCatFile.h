@@ -0,0 +1,148 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Identifier, type and size of a Git object, as reported by "git cat-file --batch-check"
+ */
+struct FGitObjectInfo
+{
+	/** SHA1 Id of the object */
+	FString Hash;
+
+	/** Type of the object (blob, tree, commit or tag) */
+	FString Type;
+
+	/** Size of the object (in bytes), or -1 if the object is missing */
+	int64 Size = -1;
+
+	bool IsValid() const
+	{
+		return Size >= 0;
+	}
+};
+
+/** Kind of requests answered by a "git cat-file" process */
+namespace EGitCatFileMode
+{
+	enum Type : uint8
+	{
+		/** "--batch-check": object info only */
+		Check,
+		/** "--batch": object info and raw content */
+		Batch,
+	};
+}
+
+/**
+ * A long-running "git cat-file --batch" (or "--batch-check") process answering object requests through its stdin/stdout pipes.
+ *
+ * Requests are serialized: a process must only be used by one thread at a time (see FGitCatFilePool).
+ */
+class FGitCatFileProcess
+{
+public:
+	/**
+	 * Launch the process
+	 * @param	InPathToGitBinary	The path to the Git binary
+	 * @param	InRepositoryRoot	The Git repository from where to run the command
+	 * @param	InMode				Kind of requests answered by the process
+	 */
+	FGitCatFileProcess(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode);
+	~FGitCatFileProcess();
+
+	/** Tells if the process is running and has not desynchronized its protocol */
+	bool IsValid() const;
+
+	/**
+	 * Get the info of a list of objects ("rev:path" or SHA1), pipelining the requests ("--batch-check" process only)
+	 * @param	InObjectNames	The names of the objects
+	 * @param	OutInfos		The info of each object, in the same order (invalid for missing objects)
+	 * @returns false if the process failed (not if some objects are missing)
+	 */
+	bool GetObjectInfos(const TArray<FString>& InObjectNames, TArray<FGitObjectInfo>& OutInfos);
+
+	/**
+	 * Read the raw content of an object ("--batch" process only)
+	 * @param	InObjectName	The name of the object (SHA1 or "rev:path")
+	 * @param	OutInfo			The info of the object (invalid if missing)
+	 * @param	OutContent		The binary content of the object
+	 * @returns true if the object was found and read
+	 */
+	bool ReadObject(const FString& InObjectName, FGitObjectInfo& OutInfo, TArray<uint8>& OutContent);
+
+private:
+	/** Write a request line to the stdin of the process */
+	bool WriteRequest(const FString& InObjectName);
+
+	/** Read the info header line of the next response */
+	bool ReadInfo(const FString& InObjectName, FGitObjectInfo& OutInfo);
+
+	/** Read a line (without its terminating newline) from the stdout of the process */
+	bool ReadLine(FString& OutLine);
+
+	/** Read a fixed number of bytes from the stdout of the process */
+	bool ReadBytes(int64 InNumBytes, TArray<uint8>& OutBytes);
+
+	/** Wait for more data to be available in the stdout pipe */
+	bool FillBuffer();
+
+	/** Stop the process */
+	void Terminate();
+
+	FProcHandle ProcessHandle;
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdInRead = nullptr;
+	void* StdInWrite = nullptr;
+
+	/** Data read from stdout but not consumed yet */
+	TArray<uint8> Buffer;
+	int32 BufferOffset = 0;
+
+	EGitCatFileMode::Type Mode;
+	bool bValid = false;
+};
+
+/**
+ * Pool of persistent "git cat-file" processes per repository, used to read blobs and their info without spawning a process per request.
+ */
+class FGitCatFilePool
+{
+public:
+	static FGitCatFilePool& Get();
+
+	/**
+	 * Get the info (SHA1 and size) of a list of objects, in one round-trip
+	 * @returns false if no process could be used: the caller should fall back to regular Git commands
+	 */
+	bool GetObjectInfos(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InObjectNames, TArray<FGitObjectInfo>& OutInfos);
+
+	/**
+	 * Read the raw content of an object (commit, tree, or blob without its smudge filters applied).
+	 * Filtered content is never read from a persistent process: "cat-file --batch --filters" reports the size of the raw blob, not of the filtered content.
+	 * @returns false if the object is missing or if no process could be used: the caller should fall back to regular Git commands
+	 */
+	bool ReadObject(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InObjectName, TArray<uint8>& OutContent);
+
+	/** Stop all processes (they are restarted on demand) */
+	void Shutdown();
+
+private:
+	TUniquePtr<FGitCatFileProcess> Acquire(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode);
+	void Release(const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode, TUniquePtr<FGitCatFileProcess>&& InProcess);
+
+	static FString MakeKey(const FString& InRepositoryRoot, const EGitCatFileMode::Type InMode);
+
+	FCriticalSection CriticalSection;
+
+	/** Idle processes, per repository and per mode */
+	TMap<FString, TArray<TUniquePtr<FGitCatFileProcess>>> IdleProcesses;
+};
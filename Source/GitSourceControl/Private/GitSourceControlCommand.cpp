@@ -5,6 +5,9 @@
 
 #include "GitSourceControlCommand.h"
 
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlUtils.h"
@@ -13,11 +16,15 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 	: Operation(InOperation)
 	, Worker(InWorker)
 	, OperationCompleteDelegate(InOperationCompleteDelegate)
+	, CommandId(0)
+	, bExecuteStarted(0)
 	, bExecuteProcessed(0)
 	, bCancelled(0)
+	, CompletionEvent(FPlatformProcess::GetSynchEventFromPool(true))
 	, bCommandSuccessful(false)
 	, bAutoDelete(true)
 	, Concurrency(EConcurrency::Synchronous)
+	, Priority(EGitCommandPriority::Foreground)
 {
 	// cache the providers settings here
 	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
@@ -28,6 +35,11 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 	PathToGitRoot = Provider.GetPathToGitRoot();
 }
 
+FGitSourceControlCommand::~FGitSourceControlCommand()
+{
+	FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+}
+
 void FGitSourceControlCommand::UpdateRepositoryRootIfSubmodule(TArray<FString>& AbsoluteFilePaths)
 {
 	PathToRepositoryRoot = GitSourceControlUtils::ChangeRepositoryRootIfSubmodule(AbsoluteFilePaths, PathToRepositoryRoot);
@@ -35,14 +47,27 @@ void FGitSourceControlCommand::UpdateRepositoryRootIfSubmodule(TArray<FString>&
 
 bool FGitSourceControlCommand::DoWork()
 {
+	{
+		// The provider no longer merges other operations into this command, nor counts on it to update files modified from now on
+		FScopeLock Lock(&StartCriticalSection);
+		FPlatformAtomics::InterlockedExchange(&bExecuteStarted, 1);
+	}
 	bCommandSuccessful = Worker->Execute(*this);
+	// Resolve and compare the new states to the cache while still on the worker thread
+	Worker->PrepareStates();
+	const bool bResult = bCommandSuccessful;
+	// Wake up a synchronous wait before flagging the command as processed: the main thread can delete it (and pool its event) as soon as it sees the flag,
+	// so do not touch this afterward. The waiter checks the flag again after waking up, so it cannot miss it.
+	CompletionEvent->Trigger();
 	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
 
-	return bCommandSuccessful;
+	return bResult;
 }
 
 void FGitSourceControlCommand::Abandon()
 {
+	// Same order as DoWork(): the command can be deleted as soon as it is flagged as processed
+	CompletionEvent->Trigger();
 	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
 }
 
@@ -55,6 +80,7 @@ void FGitSourceControlCommand::DoThreadedWork()
 void FGitSourceControlCommand::Cancel()
 {
 	FPlatformAtomics::InterlockedExchange(&bCancelled, 1);
+	CompletionEvent->Trigger();
 }
 
 bool FGitSourceControlCommand::IsCanceled() const
@@ -62,21 +88,44 @@ bool FGitSourceControlCommand::IsCanceled() const
 	return bCancelled != 0;
 }
 
+bool FGitSourceControlCommand::AppendCoalescedOperationsIfNotStarted(TArray<TPair<TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>, FSourceControlOperationComplete>>& InOutOperations)
+{
+	FScopeLock Lock(&StartCriticalSection);
+	if (IsStarted())
+	{
+		return false;
+	}
+	CoalescedOperations.Append(MoveTemp(InOutOperations));
+	return true;
+}
+
 ECommandResult::Type FGitSourceControlCommand::ReturnResults()
 {
 	// Save any messages that have accumulated
 	for (const auto& String : ResultInfo.InfoMessages)
 	{
 		Operation->AddInfoMessge(FText::FromString(String));
+		for (const auto& CoalescedOperation : CoalescedOperations)
+		{
+			CoalescedOperation.Key->AddInfoMessge(FText::FromString(String));
+		}
 	}
 	for (const auto& String : ResultInfo.ErrorMessages)
 	{
 		Operation->AddErrorMessge(FText::FromString(String));
+		for (const auto& CoalescedOperation : CoalescedOperations)
+		{
+			CoalescedOperation.Key->AddErrorMessge(FText::FromString(String));
+		}
 	}
 
 	// run the completion delegate if we have one bound
 	ECommandResult::Type Result = bCancelled ? ECommandResult::Cancelled : (bCommandSuccessful ? ECommandResult::Succeeded : ECommandResult::Failed);
 	OperationCompleteDelegate.ExecuteIfBound(Operation, Result);
+	for (const auto& CoalescedOperation : CoalescedOperations)
+	{
+		CoalescedOperation.Value.ExecuteIfBound(CoalescedOperation.Key, Result);
+	}
 
 	return Result;
 }
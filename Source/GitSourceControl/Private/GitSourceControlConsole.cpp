@@ -5,6 +5,7 @@
 #include "HAL/IConsoleManager.h"
 #include "ISourceControlModule.h"
 
+#include "GitSourceControlExecutor.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlUtils.h"
 
@@ -16,6 +17,14 @@ static FAutoConsoleCommand g_executeGitConsoleCommand(TEXT("git"),
 	TEXT("Type 'git help' to get a command list."),
 	FConsoleCommandWithArgsDelegate::CreateStatic(&GitSourceControlConsole::ExecuteGitConsoleCommand));
 
+static FAutoConsoleCommand g_executeMemReportConsoleCommand(TEXT("GitSourceControl.MemReport"),
+	TEXT("Log the memory used by the state cache of the Git plugin, in total and per file."),
+	FConsoleCommandDelegate::CreateStatic(&GitSourceControlConsole::ExecuteMemReportConsoleCommand));
+
+static FAutoConsoleCommand g_executeExecutorStatsConsoleCommand(TEXT("GitSourceControl.ExecutorStats"),
+	TEXT("Log the queue depths and the timings of the read and write lanes running the commands of the Git plugin."),
+	FConsoleCommandDelegate::CreateStatic(&GitSourceControlConsole::ExecuteExecutorStatsConsoleCommand));
+
 void GitSourceControlConsole::ExecuteGitConsoleCommand(const TArray<FString>& a_args)
 {
 	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
@@ -42,3 +51,14 @@ void GitSourceControlConsole::ExecuteGitConsoleCommand(const TArray<FString>& a_
 
 	UE_LOG(LogSourceControl, Log, TEXT("Output:\n%s"), *Results);
 }
+
+void GitSourceControlConsole::ExecuteMemReportConsoleCommand()
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	GitSourceControl.GetProvider().LogStateCacheMemoryReport();
+}
+
+void GitSourceControlConsole::ExecuteExecutorStatsConsoleCommand()
+{
+	FGitSourceControlExecutor::Get().LogStats();
+}
@@ -15,4 +15,10 @@ class GitSourceControlConsole
 public:
 	// Git Command Line Interface: Run 'git' commands directly from the Unreal Editor Console.
 	static void ExecuteGitConsoleCommand(const TArray<FString>& a_args);
+
+	// Memory report of the revision control state cache of the plugin.
+	static void ExecuteMemReportConsoleCommand();
+
+	// Statistics of the lanes of the executor running the revision control commands of the plugin.
+	static void ExecuteExecutorStatsConsoleCommand();
 };
\ No newline at end of file
@@ -0,0 +1,444 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlExecutor.h"
+
+#include "GitSourceControlCommand.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlOperation.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+
+namespace GitExecutorConstants
+{
+/** Maximum number of commands of the read lane running in parallel: a few "git status" or "git log" at once are enough to keep the disk busy */
+const int32 MaxRunningReads = 4;
+
+/** Maximum number of threads helping the commands to run their batches of files: with the threads of the commands themselves, this caps the Git processes running at once */
+const int32 MaxBatchThreads = 8;
+
+/** Stack size of the threads of the pool */
+const uint32 ThreadStackSize = 128 * 1024;
+
+/** Above this number of commands waiting in a lane, warn about it */
+const int32 QueueDepthWarning = 32;
+
+/** Maximum time a Background command waits for the more urgent ones each time it yields (in seconds) */
+const double MaxYieldSeconds = 1.0;
+
+/** Polling interval while yielding (in seconds) */
+const float YieldSleepSeconds = 0.01f;
+} // namespace GitExecutorConstants
+
+/** Priority of the command running on this thread */
+static thread_local EGitCommandPriority::Type GCurrentCommandPriority = EGitCommandPriority::Foreground;
+
+static const TCHAR* LexToString(const EGitCommandPriority::Type InPriority)
+{
+	switch (InPriority)
+	{
+	case EGitCommandPriority::Interactive: return TEXT("interactive");
+	case EGitCommandPriority::Foreground: return TEXT("foreground");
+	case EGitCommandPriority::Background: return TEXT("background");
+	default: return TEXT("unknown");
+	}
+}
+
+/** Run a command on a thread of the pool, then tell the executor to start the next command of its lane */
+class FGitSourceControlExecutor::FTask : public IQueuedWork
+{
+public:
+	FTask(FGitSourceControlExecutor& InExecutor, const FQueuedCommand& InQueuedCommand, const ELane InLane)
+		: Executor(InExecutor)
+		, Command(*InQueuedCommand.Command)
+		, Lane(InLane)
+		, Priority(InQueuedCommand.Command->Priority)
+		, RepositoryRoot(InQueuedCommand.Command->PathToRepositoryRoot)
+		, QueuedTime(InQueuedCommand.QueuedTime)
+	{
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		GCurrentCommandPriority = Priority;
+		// The command can be deleted by the main thread as soon as it is processed: do not touch it afterward
+		Command.DoThreadedWork();
+		GCurrentCommandPriority = EGitCommandPriority::Foreground;
+		const double EndTime = FPlatformTime::Seconds();
+		Executor.OnCommandFinished(Lane, Priority, RepositoryRoot, StartTime - QueuedTime, EndTime - StartTime);
+		delete this;
+	}
+
+	virtual void Abandon() override
+	{
+		// Release the lane before the command, which can then be deleted by the main thread
+		Executor.OnCommandFinished(Lane, Priority, RepositoryRoot, FPlatformTime::Seconds() - QueuedTime, 0.0);
+		Command.Abandon();
+		delete this;
+	}
+
+private:
+	FGitSourceControlExecutor& Executor;
+	FGitSourceControlCommand& Command;
+	const ELane Lane;
+	const EGitCommandPriority::Type Priority;
+	const FString RepositoryRoot;
+	const double QueuedTime;
+};
+
+/** Run a task on a batch thread on behalf of a command, which waits for it unless it can retract it */
+class FGitSourceControlExecutor::FParallelTask : public IQueuedWork
+{
+public:
+	explicit FParallelTask(TFunctionRef<void()> InTask)
+		: Task(InTask)
+		, Priority(GCurrentCommandPriority)
+		, DoneEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	{
+	}
+
+	~FParallelTask()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(DoneEvent);
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		// Background batches keep yielding to the more urgent commands
+		GCurrentCommandPriority = Priority;
+		Task();
+		GCurrentCommandPriority = EGitCommandPriority::Foreground;
+		// The calling thread deletes the task as soon as it is triggered: do not touch it afterward
+		DoneEvent->Trigger();
+	}
+
+	virtual void Abandon() override
+	{
+		DoneEvent->Trigger();
+	}
+
+	void Wait()
+	{
+		DoneEvent->Wait();
+	}
+
+private:
+	TFunctionRef<void()> Task;
+	const EGitCommandPriority::Type Priority;
+	FEvent* DoneEvent;
+};
+
+FGitSourceControlExecutor& FGitSourceControlExecutor::Get()
+{
+	static FGitSourceControlExecutor Instance;
+	return Instance;
+}
+
+bool FGitSourceControlExecutor::IsWriteOperation(const FName& InOperationName)
+{
+	// Commands writing the index (add, rm, reset, checkout, commit, merge...): "Fetch" only updates the remote-tracking references, so it runs in the read lane
+	static const TSet<FName> WriteOperations = {
+		TEXT("CheckIn"),
+		TEXT("MarkForAdd"),
+		TEXT("Delete"),
+		TEXT("Revert"),
+		TEXT("Sync"),
+		TEXT("Copy"),
+		TEXT("Resolve"),
+		TEXT("MoveToChangelist"),
+		TEXT("UpdateChangelistsStatus"),
+	};
+	return WriteOperations.Contains(InOperationName);
+}
+
+EGitCommandPriority::Type FGitSourceControlExecutor::GetCurrentPriority()
+{
+	return GCurrentCommandPriority;
+}
+
+void FGitSourceControlExecutor::YieldToHigherPriority(const EGitCommandPriority::Type InPriority)
+{
+	auto HasHigherPriorityCommands = [this, InPriority]()
+	{
+		FScopeLock Lock(&CriticalSection);
+		for (int32 Priority = 0; Priority < InPriority; Priority++)
+		{
+			if (NumRunningByPriority[Priority] > 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	if (!HasHigherPriorityCommands())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	double Elapsed = 0.0;
+	do
+	{
+		FPlatformProcess::Sleep(GitExecutorConstants::YieldSleepSeconds);
+		Elapsed = FPlatformTime::Seconds() - StartTime;
+	}
+	while (Elapsed < GitExecutorConstants::MaxYieldSeconds && HasHigherPriorityCommands());
+
+	UE_LOG(LogSourceControl, VeryVerbose, TEXT("GitSourceControlExecutor: %s command yielded for %.1f ms"), LexToString(InPriority), Elapsed * 1000.0);
+
+	FScopeLock Lock(&CriticalSection);
+	NumYields++;
+	YieldSeconds += Elapsed;
+}
+
+void FGitSourceControlExecutor::RunParallelTasks(const int32 InNumTasks, TFunctionRef<void()> InTask)
+{
+	FQueuedThreadPool* Pool = nullptr;
+	if (InNumTasks > 1)
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (BatchThreadPool == nullptr)
+		{
+			NumBatchThreads = FMath::Clamp(FPlatformMisc::NumberOfCores() / 2, 1, GitExecutorConstants::MaxBatchThreads);
+			BatchThreadPool = FQueuedThreadPool::Allocate();
+			BatchThreadPool->Create(NumBatchThreads, GitExecutorConstants::ThreadStackSize, TPri_Normal, TEXT("GitSourceControlBatchPool"));
+			UE_LOG(LogSourceControl, Verbose, TEXT("GitSourceControlExecutor: started %d batch threads"), NumBatchThreads);
+		}
+		Pool = BatchThreadPool;
+	}
+
+	TArray<TUniquePtr<FParallelTask>> ParallelTasks;
+	if (Pool)
+	{
+		ParallelTasks.Reserve(InNumTasks - 1);
+		for (int32 TaskIndex = 1; TaskIndex < InNumTasks; TaskIndex++)
+		{
+			ParallelTasks.Add(MakeUnique<FParallelTask>(InTask));
+			Pool->AddQueuedWork(ParallelTasks.Last().Get());
+		}
+	}
+
+	InTask();
+
+	// The tasks still queued have nothing left to do: take them back instead of waiting for a batch thread
+	for (const TUniquePtr<FParallelTask>& ParallelTask : ParallelTasks)
+	{
+		if (!Pool->RetractQueuedWork(ParallelTask.Get()))
+		{
+			ParallelTask->Wait();
+		}
+	}
+}
+
+void FGitSourceControlExecutor::Enqueue(TArray<FQueuedCommand>& InOutQueue, const FQueuedCommand& InQueuedCommand)
+{
+	int32 Index = InOutQueue.Num();
+	while (Index > 0 && InOutQueue[Index - 1].Command->Priority > InQueuedCommand.Command->Priority)
+	{
+		Index--;
+	}
+	InOutQueue.Insert(InQueuedCommand, Index);
+}
+
+int32 FGitSourceControlExecutor::GetMaxRunningReads(const EGitCommandPriority::Type InPriority) const
+{
+	switch (InPriority)
+	{
+	case EGitCommandPriority::Interactive:
+		// One slot is kept for the commands the user is waiting for
+		return MaxRunningReads + 1;
+	case EGitCommandPriority::Background:
+		// Never take all the slots, so that a Foreground command does not have to wait for a fetch or a full status (MaxRunningReads is at least 2)
+		return MaxRunningReads - 1;
+	default:
+		return MaxRunningReads;
+	}
+}
+
+void FGitSourceControlExecutor::Submit(FGitSourceControlCommand& InCommand)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (ThreadPool == nullptr)
+	{
+		// Two more threads than the read lane: one for its Interactive slot, one so that a write never waits for the readers
+		// At least two slots, so that the Background commands always leave one to the other commands
+		MaxRunningReads = FMath::Clamp(FPlatformMisc::NumberOfCores() / 2, 2, GitExecutorConstants::MaxRunningReads);
+		ThreadPool = FQueuedThreadPool::Allocate();
+		ThreadPool->Create(MaxRunningReads + 2, GitExecutorConstants::ThreadStackSize, TPri_Normal, TEXT("GitSourceControlPool"));
+		UE_LOG(LogSourceControl, Verbose, TEXT("GitSourceControlExecutor: started %d threads"), MaxRunningReads + 2);
+	}
+
+	const ELane Lane = IsWriteOperation(InCommand.Operation->GetName()) ? Write : Read;
+	const FQueuedCommand QueuedCommand{&InCommand, FPlatformTime::Seconds()};
+	FLaneStats& Stats = LaneStats[Lane];
+	Stats.NumSubmitted++;
+
+	if (Lane == Write)
+	{
+		FWriteLane& WriteLane = WriteLanes.FindOrAdd(InCommand.PathToRepositoryRoot);
+		if (!WriteLane.bBusy)
+		{
+			WriteLane.bBusy = true;
+			StartCommand(QueuedCommand, Lane);
+			return;
+		}
+		Enqueue(WriteLane.Queue, QueuedCommand);
+	}
+	else
+	{
+		if (Stats.NumRunning < GetMaxRunningReads(InCommand.Priority))
+		{
+			StartCommand(QueuedCommand, Lane);
+			return;
+		}
+		Enqueue(ReadQueue, QueuedCommand);
+	}
+
+	Stats.NumQueued++;
+	if (Stats.NumQueued > Stats.MaxQueued)
+	{
+		Stats.MaxQueued = Stats.NumQueued;
+		if (Stats.MaxQueued == GitExecutorConstants::QueueDepthWarning)
+		{
+			UE_LOG(LogSourceControl, Warning, TEXT("GitSourceControlExecutor: %d commands waiting for the %s lane"), Stats.NumQueued, Lane == Write ? TEXT("write") : TEXT("read"));
+		}
+	}
+}
+
+void FGitSourceControlExecutor::StartCommand(const FQueuedCommand& InQueuedCommand, const ELane InLane)
+{
+	LaneStats[InLane].NumRunning++;
+	NumRunningByPriority[InQueuedCommand.Command->Priority]++;
+	ThreadPool->AddQueuedWork(new FTask(*this, InQueuedCommand, InLane));
+}
+
+void FGitSourceControlExecutor::OnCommandFinished(const ELane InLane, const EGitCommandPriority::Type InPriority, const FString& InRepositoryRoot, const double InQueueSeconds, const double InExecuteSeconds)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	NumRunningByPriority[InPriority]--;
+
+	FLaneStats& Stats = LaneStats[InLane];
+	Stats.NumRunning--;
+	Stats.NumCompleted++;
+	Stats.QueueSeconds += InQueueSeconds;
+	Stats.ExecuteSeconds += InExecuteSeconds;
+
+	if (ThreadPool == nullptr)
+	{
+		// Shutting down
+		return;
+	}
+
+	// Start the next command of the lane, the most urgent being at the front of the queue
+	if (InLane == Write)
+	{
+		FWriteLane* WriteLane = WriteLanes.Find(InRepositoryRoot);
+		if (WriteLane && WriteLane->Queue.Num() > 0)
+		{
+			const FQueuedCommand QueuedCommand = WriteLane->Queue[0];
+			WriteLane->Queue.RemoveAt(0);
+			Stats.NumQueued--;
+			StartCommand(QueuedCommand, InLane);
+		}
+		else
+		{
+			WriteLanes.Remove(InRepositoryRoot);
+		}
+	}
+	else
+	{
+		while (ReadQueue.Num() > 0 && Stats.NumRunning < GetMaxRunningReads(ReadQueue[0].Command->Priority))
+		{
+			const FQueuedCommand QueuedCommand = ReadQueue[0];
+			ReadQueue.RemoveAt(0);
+			Stats.NumQueued--;
+			StartCommand(QueuedCommand, InLane);
+		}
+	}
+}
+
+void FGitSourceControlExecutor::Shutdown()
+{
+	FQueuedThreadPool* ThreadPoolToDestroy = nullptr;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		// The commands never started are processed by the provider as abandoned
+		for (const FQueuedCommand& QueuedCommand : ReadQueue)
+		{
+			QueuedCommand.Command->Abandon();
+		}
+		ReadQueue.Empty();
+		for (const TPair<FString, FWriteLane>& WriteLane : WriteLanes)
+		{
+			for (const FQueuedCommand& QueuedCommand : WriteLane.Value.Queue)
+			{
+				QueuedCommand.Command->Abandon();
+			}
+		}
+		WriteLanes.Empty();
+		for (FLaneStats& Stats : LaneStats)
+		{
+			Stats.NumQueued = 0;
+		}
+
+		ThreadPoolToDestroy = ThreadPool;
+		ThreadPool = nullptr;
+	}
+
+	// Wait for the running commands outside of the lock, since they call back OnCommandFinished()
+	if (ThreadPoolToDestroy)
+	{
+		ThreadPoolToDestroy->Destroy();
+		delete ThreadPoolToDestroy;
+	}
+
+	// No command is running anymore, so no batch either
+	FQueuedThreadPool* BatchThreadPoolToDestroy = nullptr;
+	{
+		FScopeLock Lock(&CriticalSection);
+		BatchThreadPoolToDestroy = BatchThreadPool;
+		BatchThreadPool = nullptr;
+	}
+	if (BatchThreadPoolToDestroy)
+	{
+		BatchThreadPoolToDestroy->Destroy();
+		delete BatchThreadPoolToDestroy;
+	}
+}
+
+int32 FGitSourceControlExecutor::GetNumQueuedReads() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return LaneStats[Read].NumQueued;
+}
+
+void FGitSourceControlExecutor::LogStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	UE_LOG(LogSourceControl, Display, TEXT("Git executor: %s, %d readers in parallel, %d repositories writing, %d batch threads"), ThreadPool ? TEXT("running") : TEXT("stopped"), MaxRunningReads, WriteLanes.Num(), BatchThreadPool ? NumBatchThreads : 0);
+	for (int32 Lane = 0; Lane < NumLanes; Lane++)
+	{
+		const FLaneStats& Stats = LaneStats[Lane];
+		const int32 NumCompleted = FMath::Max(Stats.NumCompleted, 1);
+		UE_LOG(LogSourceControl, Display, TEXT("  %s lane: %d submitted, %d completed, %d running, %d queued (max %d), average wait %.1f ms, average execution %.1f ms"),
+			Lane == Write ? TEXT("write") : TEXT("read"), Stats.NumSubmitted, Stats.NumCompleted, Stats.NumRunning, Stats.NumQueued, Stats.MaxQueued,
+			Stats.QueueSeconds * 1000.0 / NumCompleted, Stats.ExecuteSeconds * 1000.0 / NumCompleted);
+	}
+	for (int32 Priority = 0; Priority < EGitCommandPriority::Num; Priority++)
+	{
+		UE_LOG(LogSourceControl, Display, TEXT("  %s commands: %d running"), LexToString(static_cast<EGitCommandPriority::Type>(Priority)), NumRunningByPriority[Priority]);
+	}
+	UE_LOG(LogSourceControl, Display, TEXT("  background commands yielded %d times for %.1f ms"), NumYields, YieldSeconds * 1000.0);
+}
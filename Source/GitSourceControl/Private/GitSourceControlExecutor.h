@@ -0,0 +1,140 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "IGitSourceControlWorker.h"
+
+class FGitSourceControlCommand;
+class FQueuedThreadPool;
+
+/**
+ * Plugin-owned thread pool running the revision control commands, instead of the engine-wide GThreadPool
+ * where they would compete with shader compilation, asset loading and other tasks.
+ *
+ * Commands are dispatched to two kinds of lanes:
+ * - a write lane per repository, running one command at a time, so that the commands writing to the index (add, rm, reset, checkout, commit...)
+ *   never race for "index.lock";
+ * - a read lane shared by all the other commands (status, log, locks...), running a few of them in parallel.
+ * Commands waiting for a lane stay in the executor, not in the thread pool: the queue depths give back-pressure to the provider.
+ *
+ * Each lane runs its commands by priority, then in order of submission. The read lane keeps a slot for the Interactive commands
+ * and never gives its last slot to a Background one, and Background commands yield between their batches of files.
+ */
+class FGitSourceControlExecutor
+{
+public:
+	static FGitSourceControlExecutor& Get();
+
+	/** Queue a command to run on the thread pool, starting the pool if needed (main thread) */
+	void Submit(FGitSourceControlCommand& InCommand);
+
+	/** Abandon the commands still waiting for a lane, and wait for the running ones to finish before stopping the threads (main thread) */
+	void Shutdown();
+
+	/** Number of commands waiting for the read lane to run (thread-safe) */
+	int32 GetNumQueuedReads() const;
+
+	/** Log the queue depths and the timings of the lanes */
+	void LogStats() const;
+
+	/** Tells if the operation writes to the index or to the references of the repository, and must run in the write lane */
+	static bool IsWriteOperation(const FName& InOperationName);
+
+	/** Priority of the command running on the current thread, Foreground when not called from a command of the executor */
+	static EGitCommandPriority::Type GetCurrentPriority();
+
+	/**
+	 * Wait while more urgent commands are running, up to a maximum delay so that the calling command is never starved (thread-safe).
+	 * Queued commands are ignored: they wait for a slot of the read lane or for the command running in their write lane, which can be the calling one.
+	 */
+	void YieldToHigherPriority(const EGitCommandPriority::Type InPriority);
+
+	/**
+	 * Run a task InNumTasks times in parallel: once on the calling thread, and the other times on the batch threads of the executor,
+	 * instead of the task graph workers the engine needs for its frames (thread-safe).
+	 * The batch threads are shared by all the commands, capping the number of Git processes their batches of files run at once:
+	 * the tasks not picked up by a batch thread by the time the calling thread is done are retracted.
+	 */
+	void RunParallelTasks(const int32 InNumTasks, TFunctionRef<void()> InTask);
+
+private:
+	enum ELane
+	{
+		Read,
+		Write,
+		NumLanes
+	};
+
+	/** A command waiting for its lane */
+	struct FQueuedCommand
+	{
+		FGitSourceControlCommand* Command;
+		double QueuedTime;
+	};
+
+	/** Queue of the write lane of a repository */
+	struct FWriteLane
+	{
+		TArray<FQueuedCommand> Queue;
+		bool bBusy = false;
+	};
+
+	/** Statistics of a lane */
+	struct FLaneStats
+	{
+		int32 NumSubmitted = 0;
+		int32 NumCompleted = 0;
+		int32 NumQueued = 0;
+		int32 MaxQueued = 0;
+		int32 NumRunning = 0;
+		double QueueSeconds = 0.0;
+		double ExecuteSeconds = 0.0;
+	};
+
+	class FTask;
+	class FParallelTask;
+
+	/** Insert a command in a queue after the commands of the same or higher priority (under the critical section) */
+	static void Enqueue(TArray<FQueuedCommand>& InOutQueue, const FQueuedCommand& InQueuedCommand);
+
+	/** Number of commands of the read lane that can run in parallel with a command of this priority */
+	int32 GetMaxRunningReads(const EGitCommandPriority::Type InPriority) const;
+
+	/** Give a command to the thread pool (under the critical section) */
+	void StartCommand(const FQueuedCommand& InQueuedCommand, const ELane InLane);
+
+	/** Called by the thread pool when a command is done, to start the next one of its lane */
+	void OnCommandFinished(const ELane InLane, const EGitCommandPriority::Type InPriority, const FString& InRepositoryRoot, const double InQueueSeconds, const double InExecuteSeconds);
+
+	/** Critical section for thread safety of the fields below */
+	mutable FCriticalSection CriticalSection;
+
+	FQueuedThreadPool* ThreadPool = nullptr;
+
+	/** Threads helping the commands to run their batches of files in parallel, started on first use */
+	FQueuedThreadPool* BatchThreadPool = nullptr;
+	int32 NumBatchThreads = 0;
+
+	/** Maximum number of commands of the read lane running in parallel */
+	int32 MaxRunningReads = 0;
+
+	/** Commands waiting for the read lane */
+	TArray<FQueuedCommand> ReadQueue;
+
+	/** Write lane of each repository */
+	TMap<FString, FWriteLane> WriteLanes;
+
+	FLaneStats LaneStats[NumLanes];
+
+	/** Number of commands running for each priority, to know when to yield */
+	int32 NumRunningByPriority[EGitCommandPriority::Num] = {};
+
+	/** Number of times Background commands yielded, and the total time they waited */
+	int32 NumYields = 0;
+	double YieldSeconds = 0.0;
+};
@@ -0,0 +1,655 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlIndex.h"
+
+#include "Algo/IsSorted.h"
+#include "Algo/StableSort.h"
+#include "Async/MappedFileHandle.h"
+#include "GitSourceControlUtils.h"
+#include "HAL/PlatformFileManager.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace GitIndexConstants
+{
+/** Size of a SHA1 object id (SHA-256 repositories are not supported) */
+const int32 HashSize = 20;
+
+/** Size of the fixed part of an index entry (stat data, mode, object id and flags), without the extended flags */
+const int32 EntryHeaderSize = 62;
+
+/** An index written less than this many seconds before being read is read again next time, since it could be rewritten with the same size and timestamp */
+const double MinIndexAgeToCache = 2.0;
+
+/** Flags of an index entry */
+const uint16 FlagAssumeValid = 0x8000;
+const uint16 FlagExtended = 0x4000;
+const uint16 ExtendedFlagSkipWorktree = 0x4000;
+const uint16 ExtendedFlagIntentToAdd = 0x2000;
+
+/** File mode of a regular file (as opposed to a symbolic link or a gitlink) */
+const uint32 ModeTypeMask = 0170000;
+const uint32 ModeRegularFile = 0100000;
+
+/** Signatures of the extensions */
+const uint32 ExtensionCacheTree = 0x54524545; // "TREE"
+const uint32 ExtensionLink = 0x6C696E6B; // "link" (split index)
+} // namespace GitIndexConstants
+
+namespace
+{
+
+uint16 ReadUInt16(const uint8* InData)
+{
+	return static_cast<uint16>((InData[0] << 8) | InData[1]);
+}
+
+uint32 ReadUInt32(const uint8* InData)
+{
+	return (static_cast<uint32>(InData[0]) << 24) | (static_cast<uint32>(InData[1]) << 16) | (static_cast<uint32>(InData[2]) << 8) | static_cast<uint32>(InData[3]);
+}
+
+uint64 ReadUInt64(const uint8* InData)
+{
+	return (static_cast<uint64>(ReadUInt32(InData)) << 32) | ReadUInt32(InData + 4);
+}
+
+FString HashToString(const uint8* InHash)
+{
+	static const TCHAR* HexDigits = TEXT("0123456789abcdef");
+	FString Hash;
+	Hash.Reserve(GitIndexConstants::HashSize * 2);
+	for (int32 Index = 0; Index < GitIndexConstants::HashSize; Index++)
+	{
+		Hash.AppendChar(HexDigits[InHash[Index] >> 4]);
+		Hash.AppendChar(HexDigits[InHash[Index] & 0x0F]);
+	}
+	return Hash;
+}
+
+FString Utf8ToString(const uint8* InData, int32 InLen)
+{
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(InData), InLen);
+	return FString(Converted.Length(), Converted.Get());
+}
+
+// Find the NUL terminating a string, or nullptr if not found before the end
+const uint8* FindNul(const uint8* InData, const uint8* InEnd)
+{
+	for (const uint8* Ptr = InData; Ptr < InEnd; Ptr++)
+	{
+		if (*Ptr == 0)
+		{
+			return Ptr;
+		}
+	}
+	return nullptr;
+}
+
+// Convert a file timestamp to the seconds and nanoseconds since the Unix epoch used by Git
+FGitIndexTime ToIndexTime(const FDateTime& InDateTime)
+{
+	const int64 Ticks = (InDateTime - FDateTime(1970, 1, 1)).GetTicks();
+	FGitIndexTime Time;
+	Time.Seconds = static_cast<uint32>(Ticks / ETimespan::TicksPerSecond);
+	Time.NanoSeconds = static_cast<uint32>((Ticks % ETimespan::TicksPerSecond) * ETimespan::NanosecondsPerTick);
+	return Time;
+}
+
+// Nanoseconds are not always available (depending on the file system, on the platform and on the Git build): only compare them if known on both sides,
+// and only to the 100ns resolution of FDateTime
+bool IsSameTime(const FGitIndexTime& InA, const FGitIndexTime& InB)
+{
+	if (InA.Seconds != InB.Seconds)
+	{
+		return false;
+	}
+	return (InA.NanoSeconds == 0) || (InB.NanoSeconds == 0) || (InA.NanoSeconds / 100 == InB.NanoSeconds / 100);
+}
+
+bool IsOlder(const FGitIndexTime& InA, const FGitIndexTime& InB)
+{
+	if (InA.Seconds != InB.Seconds)
+	{
+		return InA.Seconds < InB.Seconds;
+	}
+	return (InA.NanoSeconds != 0) && (InB.NanoSeconds != 0) && (InA.NanoSeconds / 100 < InB.NanoSeconds / 100);
+}
+
+/**
+ * Decode a bitmap compressed with EWAH (as serialized by Git) into the positions of its set bits
+ * @returns the number of bytes read, or -1 if the bitmap is corrupted
+ */
+int64 DecodeEwahBitmap(const uint8* InData, const uint8* InEnd, TArray<int32>& OutPositions)
+{
+	// uint32 number of bits, uint32 number of 64 bits words, the words, and the uint32 position of the last run length word
+	if (InEnd - InData < 8)
+	{
+		return -1;
+	}
+	const uint32 NumWords = ReadUInt32(InData + 4);
+	const int64 Size = 8 + static_cast<int64>(NumWords) * 8 + 4;
+	if (InEnd - InData < Size)
+	{
+		return -1;
+	}
+	const uint8* Words = InData + 8;
+	int64 Position = 0;
+	for (uint32 WordIndex = 0; WordIndex < NumWords;)
+	{
+		// A run length word: a bit repeated for a number of words, followed by a number of literal words
+		const uint64 RunLengthWord = ReadUInt64(Words + 8 * WordIndex++);
+		const bool bRunningBit = (RunLengthWord & 1) != 0;
+		const int64 RunningLength = static_cast<int64>((RunLengthWord >> 1) & 0xFFFFFFFF) * 64;
+		const uint32 NumLiteralWords = static_cast<uint32>(RunLengthWord >> 33);
+		if (bRunningBit)
+		{
+			for (int64 Bit = 0; Bit < RunningLength; Bit++)
+			{
+				OutPositions.Add(static_cast<int32>(Position + Bit));
+			}
+		}
+		Position += RunningLength;
+		for (uint32 LiteralIndex = 0; (LiteralIndex < NumLiteralWords) && (WordIndex < NumWords); LiteralIndex++)
+		{
+			const uint64 LiteralWord = ReadUInt64(Words + 8 * WordIndex++);
+			for (int32 Bit = 0; Bit < 64; Bit++)
+			{
+				if (LiteralWord & (1ull << Bit))
+				{
+					OutPositions.Add(static_cast<int32>(Position + Bit));
+				}
+			}
+			Position += 64;
+		}
+	}
+	return Size;
+}
+
+/** Content of one index file */
+struct FGitIndexFile
+{
+	TArray<FGitIndexEntry> Entries;
+	TMap<FString, FString> TreeHashes;
+
+	/** Split index: id of the shared index, and positions of its entries deleted or replaced by the entries of this file */
+	FString SharedIndexHash;
+	TArray<int32> DeletedPositions;
+	TArray<int32> ReplacedPositions;
+};
+
+// Parse a decimal number of the cache tree, terminated by the provided character
+bool ParseCacheTreeNumber(const uint8*& InOutPtr, const uint8* InEnd, const uint8 InTerminator, int32& OutNumber)
+{
+	bool bNegative = false;
+	if ((InOutPtr < InEnd) && (*InOutPtr == '-'))
+	{
+		bNegative = true;
+		InOutPtr++;
+	}
+	int32 Number = 0;
+	for (; (InOutPtr < InEnd) && (*InOutPtr != InTerminator); InOutPtr++)
+	{
+		if ((*InOutPtr < '0') || (*InOutPtr > '9'))
+		{
+			return false;
+		}
+		Number = Number * 10 + (*InOutPtr - '0');
+	}
+	if (InOutPtr >= InEnd)
+	{
+		return false;
+	}
+	InOutPtr++; // skip the terminator
+	OutNumber = bNegative ? -Number : Number;
+	return true;
+}
+
+/**
+ * Parse a node of the cache tree and its subtrees: "<name>\0<entry count> <subtree count>\n<object id>"
+ * The entry count is -1 if the node was invalidated, in which case there is no object id.
+ */
+bool ParseCacheTree(const uint8*& InOutPtr, const uint8* InEnd, const FString& InParentPath, TMap<FString, FString>& OutTreeHashes)
+{
+	const uint8* NameEnd = FindNul(InOutPtr, InEnd);
+	if (!NameEnd)
+	{
+		return false;
+	}
+	const FString Name = Utf8ToString(InOutPtr, static_cast<int32>(NameEnd - InOutPtr));
+	const FString Path = InParentPath.IsEmpty() ? Name : InParentPath / Name;
+	InOutPtr = NameEnd + 1;
+
+	int32 NumEntries;
+	int32 NumSubtrees;
+	if (!ParseCacheTreeNumber(InOutPtr, InEnd, ' ', NumEntries) || !ParseCacheTreeNumber(InOutPtr, InEnd, '\n', NumSubtrees))
+	{
+		return false;
+	}
+	if (NumEntries >= 0)
+	{
+		if (InEnd - InOutPtr < GitIndexConstants::HashSize)
+		{
+			return false;
+		}
+		OutTreeHashes.Add(Path, HashToString(InOutPtr));
+		InOutPtr += GitIndexConstants::HashSize;
+	}
+	for (int32 SubtreeIndex = 0; SubtreeIndex < NumSubtrees; SubtreeIndex++)
+	{
+		if (!ParseCacheTree(InOutPtr, InEnd, Path, OutTreeHashes))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ParseIndex(const uint8* InData, const int64 InSize, FGitIndexFile& OutIndex)
+{
+	// Header: "DIRC" signature, version and number of entries; and the file ends with the checksum of its content
+	if ((InSize < 12 + GitIndexConstants::HashSize) || (FMemory::Memcmp(InData, "DIRC", 4) != 0))
+	{
+		return false;
+	}
+	const uint32 Version = ReadUInt32(InData + 4);
+	if ((Version < 2) || (Version > 4))
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Unsupported Git index version %u"), Version);
+		return false;
+	}
+	const uint32 NumEntries = ReadUInt32(InData + 8);
+	const uint8* Ptr = InData + 12;
+	const uint8* End = InData + InSize - GitIndexConstants::HashSize;
+
+	OutIndex.Entries.Reserve(NumEntries);
+	TArray<uint8> Name; // with version 4, the path of each entry is prefix-compressed from the path of the previous one
+	for (uint32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
+	{
+		if (End - Ptr < GitIndexConstants::EntryHeaderSize)
+		{
+			return false;
+		}
+		FGitIndexEntry& Entry = OutIndex.Entries.AddDefaulted_GetRef();
+		// ctime (8 bytes), mtime (8), dev, ino, mode, uid, gid, size (4 each), object id (20) and flags (2)
+		Entry.MTime.Seconds = ReadUInt32(Ptr + 8);
+		Entry.MTime.NanoSeconds = ReadUInt32(Ptr + 12);
+		Entry.Mode = ReadUInt32(Ptr + 24);
+		Entry.Size = ReadUInt32(Ptr + 36);
+		const uint16 Flags = ReadUInt16(Ptr + 60);
+		Entry.Stage = static_cast<uint8>((Flags >> 12) & 0x3);
+		Entry.bAssumeValid = (Flags & GitIndexConstants::FlagAssumeValid) != 0;
+		int32 HeaderSize = GitIndexConstants::EntryHeaderSize;
+		if (Flags & GitIndexConstants::FlagExtended)
+		{
+			if ((Version < 3) || (End - Ptr < HeaderSize + 2))
+			{
+				return false;
+			}
+			const uint16 ExtendedFlags = ReadUInt16(Ptr + HeaderSize);
+			Entry.bSkipWorktree = (ExtendedFlags & GitIndexConstants::ExtendedFlagSkipWorktree) != 0;
+			Entry.bIntentToAdd = (ExtendedFlags & GitIndexConstants::ExtendedFlagIntentToAdd) != 0;
+			HeaderSize += 2;
+		}
+
+		const uint8* NamePtr = Ptr + HeaderSize;
+		if (Version == 4)
+		{
+			// Number of bytes to remove from the end of the previous path (variable-length integer), followed by the NUL-terminated suffix
+			uint64 NumBytesToRemove = 0;
+			uint8 Byte;
+			do
+			{
+				if (NamePtr >= End)
+				{
+					return false;
+				}
+				Byte = *NamePtr++;
+				NumBytesToRemove = (NumBytesToRemove << 7) | (Byte & 0x7F);
+				if (Byte & 0x80)
+				{
+					NumBytesToRemove++;
+				}
+			} while (Byte & 0x80);
+			if (NumBytesToRemove > static_cast<uint64>(Name.Num()))
+			{
+				return false;
+			}
+			const uint8* NameEnd = FindNul(NamePtr, End);
+			if (!NameEnd)
+			{
+				return false;
+			}
+			Name.SetNum(Name.Num() - static_cast<int32>(NumBytesToRemove), false);
+			Name.Append(NamePtr, static_cast<int32>(NameEnd - NamePtr));
+			Ptr = NameEnd + 1;
+		}
+		else
+		{
+			const uint8* NameEnd = FindNul(NamePtr, End);
+			if (!NameEnd)
+			{
+				return false;
+			}
+			const int32 NameLen = static_cast<int32>(NameEnd - NamePtr);
+			Name.Reset();
+			Name.Append(NamePtr, NameLen);
+			// Entries are padded with 1 to 8 NUL bytes to keep their size a multiple of 8
+			Ptr += (HeaderSize + NameLen + 8) & ~7;
+		}
+		Entry.Path = Utf8ToString(Name.GetData(), Name.Num());
+	}
+
+	// Extensions: signature, size and content
+	while (End - Ptr >= 8)
+	{
+		const uint32 Signature = ReadUInt32(Ptr);
+		const uint32 Size = ReadUInt32(Ptr + 4);
+		Ptr += 8;
+		if (Size > static_cast<uint64>(End - Ptr))
+		{
+			return false;
+		}
+		const uint8* ExtensionEnd = Ptr + Size;
+		if (Signature == GitIndexConstants::ExtensionCacheTree)
+		{
+			const uint8* TreePtr = Ptr;
+			while (TreePtr < ExtensionEnd)
+			{
+				if (!ParseCacheTree(TreePtr, ExtensionEnd, FString(), OutIndex.TreeHashes))
+				{
+					// The cache tree is only an optimization
+					OutIndex.TreeHashes.Empty();
+					break;
+				}
+			}
+		}
+		else if (Signature == GitIndexConstants::ExtensionLink)
+		{
+			if (Size < static_cast<uint32>(GitIndexConstants::HashSize))
+			{
+				return false;
+			}
+			OutIndex.SharedIndexHash = HashToString(Ptr);
+			const uint8* BitmapPtr = Ptr + GitIndexConstants::HashSize;
+			if (BitmapPtr < ExtensionEnd)
+			{
+				const int64 DeleteBitmapSize = DecodeEwahBitmap(BitmapPtr, ExtensionEnd, OutIndex.DeletedPositions);
+				if (DeleteBitmapSize < 0)
+				{
+					return false;
+				}
+				if (DecodeEwahBitmap(BitmapPtr + DeleteBitmapSize, ExtensionEnd, OutIndex.ReplacedPositions) < 0)
+				{
+					return false;
+				}
+			}
+		}
+		else if ((Signature >> 24) < 'A' || (Signature >> 24) > 'Z')
+		{
+			// Extensions not starting with an uppercase letter are mandatory (ie. "sdir" of a sparse index)
+			UE_LOG(LogSourceControl, Log, TEXT("Unsupported Git index extension '%c%c%c%c'"),
+				static_cast<TCHAR>(Signature >> 24), static_cast<TCHAR>((Signature >> 16) & 0xFF), static_cast<TCHAR>((Signature >> 8) & 0xFF), static_cast<TCHAR>(Signature & 0xFF));
+			return false;
+		}
+		Ptr = ExtensionEnd;
+	}
+
+	return true;
+}
+
+// Memory-map an index file only for the time needed to parse it
+bool ReadIndexFile(const FString& InFilename, FGitIndexFile& OutIndex)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*InFilename));
+	if (!MappedFile)
+	{
+		return false;
+	}
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion)
+	{
+		return false;
+	}
+	const bool bParsed = ParseIndex(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize(), OutIndex);
+	if (!bParsed)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Failed to parse the Git index '%s'"), *InFilename);
+	}
+	return bParsed;
+}
+
+bool IsLowerPath(const FGitIndexEntry& InA, const FGitIndexEntry& InB)
+{
+	const int32 Compare = InA.Path.Compare(InB.Path, ESearchCase::CaseSensitive);
+	return (Compare < 0) || ((Compare == 0) && (InA.Stage < InB.Stage));
+}
+
+} // namespace
+
+bool FGitIndex::Read(const FString& InGitDirectory)
+{
+	const FString IndexFilename = InGitDirectory / TEXT("index");
+	const FFileStatData IndexStatData = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*IndexFilename);
+	if (!IndexStatData.bIsValid)
+	{
+		return false;
+	}
+	ReadTime = FDateTime::UtcNow();
+	IndexFileSize = IndexStatData.FileSize;
+	IndexFileTime = IndexStatData.ModificationTime;
+	IndexMTime = ToIndexTime(IndexStatData.ModificationTime);
+
+	FGitIndexFile IndexFile;
+	if (!ReadIndexFile(IndexFilename, IndexFile))
+	{
+		return false;
+	}
+	TreeHashes = MoveTemp(IndexFile.TreeHashes);
+
+	if (IndexFile.SharedIndexHash.IsEmpty())
+	{
+		Entries = MoveTemp(IndexFile.Entries);
+	}
+	else
+	{
+		// Split index: the entries of the index file replace, or are added to, the entries of the shared index
+		FGitIndexFile SharedIndexFile;
+		if (!ReadIndexFile(InGitDirectory / (TEXT("sharedindex.") + IndexFile.SharedIndexHash), SharedIndexFile) || !SharedIndexFile.SharedIndexHash.IsEmpty())
+		{
+			return false;
+		}
+		TArray<FGitIndexEntry>& SharedEntries = SharedIndexFile.Entries;
+		int32 SplitEntryIndex = 0;
+		for (const int32 Position : IndexFile.ReplacedPositions)
+		{
+			// A replacing entry has an empty path: it keeps the path of the entry it replaces
+			if (!SharedEntries.IsValidIndex(Position) || !IndexFile.Entries.IsValidIndex(SplitEntryIndex))
+			{
+				return false;
+			}
+			FString Path = MoveTemp(SharedEntries[Position].Path);
+			SharedEntries[Position] = MoveTemp(IndexFile.Entries[SplitEntryIndex++]);
+			SharedEntries[Position].Path = MoveTemp(Path);
+		}
+		TBitArray<> Deleted(false, SharedEntries.Num());
+		for (const int32 Position : IndexFile.DeletedPositions)
+		{
+			if (!SharedEntries.IsValidIndex(Position))
+			{
+				return false;
+			}
+			Deleted[Position] = true;
+		}
+		Entries.Reserve(SharedEntries.Num() + IndexFile.Entries.Num() - SplitEntryIndex);
+		for (int32 SharedEntryIndex = 0; SharedEntryIndex < SharedEntries.Num(); SharedEntryIndex++)
+		{
+			if (!Deleted[SharedEntryIndex])
+			{
+				Entries.Add(MoveTemp(SharedEntries[SharedEntryIndex]));
+			}
+		}
+		for (; SplitEntryIndex < IndexFile.Entries.Num(); SplitEntryIndex++)
+		{
+			Entries.Add(MoveTemp(IndexFile.Entries[SplitEntryIndex]));
+		}
+	}
+
+	// Git sorts entries by the bytes of their UTF-8 path, which only differs from the order of TCHAR strings for characters outside of the BMP
+	if (!Algo::IsSorted(Entries, IsLowerPath))
+	{
+		Algo::StableSort(Entries, IsLowerPath);
+	}
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("Read the Git index of '%s': %d entries, %d cached trees"), *InGitDirectory, Entries.Num(), TreeHashes.Num());
+
+	return true;
+}
+
+int32 FGitIndex::LowerBound(FStringView InRelativePath) const
+{
+	int32 First = 0;
+	int32 Count = Entries.Num();
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		const int32 Middle = First + Step;
+		if (FStringView(Entries[Middle].Path).Compare(InRelativePath, ESearchCase::CaseSensitive) < 0)
+		{
+			First = Middle + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+	return First;
+}
+
+const FGitIndexEntry* FGitIndex::Find(FStringView InRelativePath) const
+{
+	const int32 Index = LowerBound(InRelativePath);
+	if (Entries.IsValidIndex(Index) && FStringView(Entries[Index].Path).Equals(InRelativePath, ESearchCase::CaseSensitive))
+	{
+		return &Entries[Index];
+	}
+	return nullptr;
+}
+
+void FGitIndex::ListFiles(FStringView InRelativeDirectory, TArray<FString>& OutRelativePaths) const
+{
+	FString Prefix(InRelativeDirectory);
+	if (!Prefix.IsEmpty() && !Prefix.EndsWith(TEXT("/")))
+	{
+		Prefix += TEXT('/');
+	}
+	const FString* PreviousPath = nullptr;
+	for (int32 Index = LowerBound(Prefix); Index < Entries.Num() && Entries[Index].Path.StartsWith(Prefix, ESearchCase::CaseSensitive); Index++)
+	{
+		// Unmerged files have one entry per stage
+		if (!PreviousPath || !PreviousPath->Equals(Entries[Index].Path, ESearchCase::CaseSensitive))
+		{
+			OutRelativePaths.Add(Entries[Index].Path);
+			PreviousPath = &Entries[Index].Path;
+		}
+	}
+}
+
+bool FGitIndex::IsUnchanged(const FGitIndexEntry& InEntry, const FString& InAbsoluteFilename) const
+{
+	if ((InEntry.Stage != 0) || InEntry.bAssumeValid || InEntry.bSkipWorktree || InEntry.bIntentToAdd)
+	{
+		return false;
+	}
+	if ((InEntry.Mode & GitIndexConstants::ModeTypeMask) != GitIndexConstants::ModeRegularFile)
+	{
+		return false;
+	}
+	// Unmerged files have other entries for their other stages
+	const int32 Index = static_cast<int32>(&InEntry - Entries.GetData());
+	if (Entries.IsValidIndex(Index + 1) && Entries[Index + 1].Path.Equals(InEntry.Path, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+
+	const FFileStatData StatData = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*InAbsoluteFilename);
+	if (!StatData.bIsValid || StatData.bIsDirectory)
+	{
+		return false;
+	}
+	if ((static_cast<uint32>(StatData.FileSize) != InEntry.Size) || !IsSameTime(ToIndexTime(StatData.ModificationTime), InEntry.MTime))
+	{
+		return false;
+	}
+	// Racily clean entry: the file could have been modified again in the same timestamp as the index was written, without changing its size
+	if (!IsOlder(InEntry.MTime, IndexMTime))
+	{
+		UE_LOG(LogSourceControl, VeryVerbose, TEXT("Index(%s) racily clean"), *InEntry.Path);
+		return false;
+	}
+	return true;
+}
+
+bool FGitIndex::GetTreeHash(const FString& InRelativeDirectory, FString& OutHash) const
+{
+	if (const FString* Hash = TreeHashes.Find(InRelativeDirectory))
+	{
+		OutHash = *Hash;
+		return true;
+	}
+	return false;
+}
+
+bool FGitIndex::IsOutdated(const FString& InGitDirectory) const
+{
+	const FFileStatData IndexStatData = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*(InGitDirectory / TEXT("index")));
+	if (!IndexStatData.bIsValid || (IndexStatData.FileSize != IndexFileSize) || (IndexStatData.ModificationTime != IndexFileTime))
+	{
+		return true;
+	}
+	return (ReadTime - IndexFileTime).GetTotalSeconds() < GitIndexConstants::MinIndexAgeToCache;
+}
+
+FGitIndexCache& FGitIndexCache::Get()
+{
+	static FGitIndexCache Instance;
+	return Instance;
+}
+
+TSharedPtr<const FGitIndex, ESPMode::ThreadSafe> FGitIndexCache::GetIndex(const FString& InRepositoryRoot)
+{
+	FString GitDirectory;
+	if (!GitSourceControlUtils::FindGitDirectory(InRepositoryRoot, GitDirectory))
+	{
+		return nullptr;
+	}
+
+	// Only one thread reads the index at a time, the others then share it
+	FScopeLock ScopeLock(&CriticalSection);
+	TSharedPtr<const FGitIndex, ESPMode::ThreadSafe>& Index = Indexes.FindOrAdd(InRepositoryRoot);
+	if (!Index.IsValid() || Index->IsOutdated(GitDirectory))
+	{
+		TSharedPtr<FGitIndex, ESPMode::ThreadSafe> NewIndex = MakeShared<FGitIndex, ESPMode::ThreadSafe>();
+		if (NewIndex->Read(GitDirectory))
+		{
+			Index = NewIndex;
+		}
+		else
+		{
+			Index.Reset();
+		}
+	}
+	return Index;
+}
+
+void FGitIndexCache::Empty()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Indexes.Empty();
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+
+/**
+ * Timestamp as stored in the Git index (seconds and nanoseconds since the Unix epoch)
+ */
+struct FGitIndexTime
+{
+	uint32 Seconds = 0;
+	uint32 NanoSeconds = 0;
+};
+
+/**
+ * An entry of the Git index: a tracked file, with the stat data cached by Git the last time it was refreshed
+ */
+struct FGitIndexEntry
+{
+	/** Path of the file, relative to the root of the repository (with '/' separators) */
+	FString Path;
+
+	/** Last modification time of the file when it was added to the index */
+	FGitIndexTime MTime;
+
+	/** Size of the file (truncated to 32 bits) */
+	uint32 Size = 0;
+
+	/** File mode (regular file, executable, symbolic link or gitlink) */
+	uint32 Mode = 0;
+
+	/** Merge stage: 0 for a normal entry, 1 (base), 2 (ours) or 3 (theirs) for an unmerged (conflicted) file */
+	uint8 Stage = 0;
+
+	/** "git update-index --assume-unchanged" */
+	bool bAssumeValid = false;
+
+	/** "git update-index --skip-worktree" (sparse checkout) */
+	bool bSkipWorktree = false;
+
+	/** "git add --intent-to-add" */
+	bool bIntentToAdd = false;
+};
+
+/**
+ * In-process reader of the Git index file (.git/index), used to enumerate tracked files and to tell which files are unchanged
+ * since they were last staged, without launching any Git process.
+ *
+ * Supports the index format versions 2 to 4, the split index ("link" extension with its EWAH bitmaps) and the cache tree ("TREE" extension).
+ * Other optional extensions (untracked cache "UNTR", file system monitor "FSMN", resolve undo "REUC"...) are skipped:
+ * untracked files still come from "git status".
+ * The index is memory-mapped only while being parsed, so that Git can always replace it.
+ */
+class FGitIndex
+{
+public:
+	/**
+	 * Read the index of a repository (and its shared index if split)
+	 * @param	InGitDirectory	The Git directory of the repository (usually "<root>/.git", see GitSourceControlUtils::FindGitDirectory())
+	 * @returns false if the index is missing or uses an unsupported format: the caller should fall back to Git commands
+	 */
+	bool Read(const FString& InGitDirectory);
+
+	/** Number of entries in the index (unmerged files have one entry per stage) */
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	/** Find the entry of a file (its first stage if unmerged), or nullptr if the file is not tracked */
+	const FGitIndexEntry* Find(FStringView InRelativePath) const;
+
+	/** List all tracked files recursively in a directory (relative to the root of the repository, empty for the whole repository) */
+	void ListFiles(FStringView InRelativeDirectory, TArray<FString>& OutRelativePaths) const;
+
+	/**
+	 * Tell if a file is unchanged in the working tree compared to the index, using the cached stat data (size and modification time).
+	 * @returns false if the file is modified, missing, not a regular file, or if its entry is "racily clean" (modified too close to the index write to be sure)
+	 */
+	bool IsUnchanged(const FGitIndexEntry& InEntry, const FString& InAbsoluteFilename) const;
+
+	/**
+	 * Get the id of the tree object of a directory, from the cache tree of the index
+	 * @returns false if the cache tree of the directory has been invalidated since the index was written (ie. by a staged change)
+	 */
+	bool GetTreeHash(const FString& InRelativeDirectory, FString& OutHash) const;
+
+	/** Tell if the index file changed since it was read (or if it was written too recently to tell) */
+	bool IsOutdated(const FString& InGitDirectory) const;
+
+private:
+	/** Find the first entry with a path not lower than the provided one */
+	int32 LowerBound(FStringView InRelativePath) const;
+
+	/** Entries, sorted by path and then by stage */
+	TArray<FGitIndexEntry> Entries;
+
+	/** Id of the tree object of each directory with a valid cache tree ("" for the root of the repository) */
+	TMap<FString, FString> TreeHashes;
+
+	/** Size and modification time of the index file when it was read */
+	int64 IndexFileSize = 0;
+	FDateTime IndexFileTime;
+
+	/** Modification time of the index file, for the detection of racily clean entries */
+	FGitIndexTime IndexMTime;
+
+	/** When the index file was read */
+	FDateTime ReadTime;
+};
+
+/**
+ * Cache of the parsed index of each repository, read again only when the index file changes.
+ */
+class FGitIndexCache
+{
+public:
+	static FGitIndexCache& Get();
+
+	/**
+	 * Get the up-to-date index of a repository
+	 * @returns nullptr if the index could not be read: the caller should fall back to Git commands
+	 */
+	TSharedPtr<const FGitIndex, ESPMode::ThreadSafe> GetIndex(const FString& InRepositoryRoot);
+
+	/** Forget all indexes */
+	void Empty();
+
+private:
+	FCriticalSection CriticalSection;
+
+	/** Index of each repository, by repository root */
+	TMap<FString, TSharedPtr<const FGitIndex, ESPMode::ThreadSafe>> Indexes;
+};
@@ -8,6 +8,7 @@
 #include "GitSourceControlModule.h"
 #include "GitSourceControlProvider.h"
 #include "GitSourceControlOperations.h"
+#include "GitSourceControlState.h"
 #include "GitSourceControlUtils.h"
 
 #include "ISourceControlModule.h"
@@ -19,6 +20,7 @@
 #include "Framework/Notifications/NotificationManager.h"
 #include "Misc/EngineVersionComparison.h"
 #include "Misc/MessageDialog.h"
+#include "Misc/PackageName.h"
 #if !UE_VERSION_OLDER_THAN(5, 1, 0)
 #include "Styling/AppStyle.h"
 #else
@@ -335,16 +337,20 @@ void FGitSourceControlMenu::RevertAllCallback(const FSourceControlOperationRef&
 		return;
 	}
 
-	// Get a list of all the checked out packages
+	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+
+	// Get a list of all the packages with local changes, from the index of the cache instead of scanning all its states
+	// like FEditorFileUtils::FindAllSubmittablePackageFiles() does through GetCachedStateByPredicate()
 	TArray<FString> PackageNames;
 	TArray<UPackage*> LoadedPackages;
-	TMap<FString, FSourceControlStatePtr> PackageStates;
-	FEditorFileUtils::FindAllSubmittablePackageFiles(PackageStates, true);
-
-	for (TMap<FString, FSourceControlStatePtr>::TConstIterator PackageIter(PackageStates); PackageIter; ++PackageIter)
+	for (const FSourceControlStateRef& State : Provider.GetCachedStatesByCategory(EGitStateCategory::LocalChanges))
 	{
-		const FString PackageName = *PackageIter.Key();
-		const FSourceControlStatePtr CurPackageSCCState = PackageIter.Value();
+		FString PackageName;
+		if (!FPackageName::IsPackageFilename(State->GetFilename()) || !FPackageName::TryConvertFilenameToLongPackageName(State->GetFilename(), PackageName))
+		{
+			continue;
+		}
 
 		UPackage* Package = FindPackage(nullptr, *PackageName);
 		if (Package != nullptr)
@@ -365,8 +371,6 @@ void FGitSourceControlMenu::RevertAllCallback(const FSourceControlOperationRef&
 	const auto FileNames = SourceControlHelpers::PackageFilenames(PackageNames);
 
 	// Launch a "Revert" Operation
-	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
-	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
 	const TSharedRef<FRevert, ESPMode::ThreadSafe> RevertOperation = ISourceControlOperation::Create<FRevert>();
 #if !UE_VERSION_OLDER_THAN(5, 0, 0)
 	const auto Result = Provider.Execute(RevertOperation, FSourceControlChangelistPtr(), FileNames);
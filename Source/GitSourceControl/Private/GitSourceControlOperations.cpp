@@ -143,9 +143,14 @@ bool FGitCheckOutWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitCheckOutWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitCheckOutWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 static FText ParseCommitResults(const TArray<FString>& InResults)
@@ -218,17 +223,33 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 		bool bDiffSuccess;
 		if (GitSourceControlUtils::GetRemoteBranchName(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, BranchName))
 		{
-			TArray<FString> Parameters {"--name-only", FString::Printf(TEXT("%s...HEAD"), *BranchName), "--"};
-			bDiffSuccess = GitSourceControlUtils::RunCommand(TEXT("diff"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters,
-															  FGitSourceControlModule::GetEmptyStringArray(), CommittedFiles, InCommand.ResultInfo.ErrorMessages);
+			TArray<FString> Parameters {"--name-only", "-z", FString::Printf(TEXT("%s...HEAD"), *BranchName), "--"};
+			bDiffSuccess = GitSourceControlUtils::RunCommandStreaming(TEXT("diff"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters,
+																	   FGitSourceControlModule::GetEmptyStringArray(),
+																	   [&CommittedFiles](FStringView RelativeFilename) { CommittedFiles.Emplace(RelativeFilename); },
+																	   InCommand.ResultInfo.ErrorMessages, '\0');
 		}
 		else
 		{
 			// Get all non-remote commits and list out their files
-			TArray<FString> Parameters {"--branches", "--not" "--remotes", "--name-only", "--pretty="};
-			bDiffSuccess = GitSourceControlUtils::RunCommand(TEXT("log"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), CommittedFiles, InCommand.ResultInfo.ErrorMessages);
-			// Dedup files list between commits
-			CommittedFiles = TSet<FString>{CommittedFiles}.Array();
+			TArray<FString> Parameters {"--branches", "--not", "--remotes", "--name-only", "-z", "--pretty="};
+			TSet<FString> CommittedFilesSet; // Dedup files list between commits
+			bDiffSuccess = GitSourceControlUtils::RunCommandStreaming(TEXT("log"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters,
+																	   FGitSourceControlModule::GetEmptyStringArray(),
+																	   [&CommittedFilesSet](FStringView RelativeFilename)
+																	   {
+																		   // Commits are separated by an empty record (or a newline before the first path)
+																		   while ((RelativeFilename.Len() > 0) && (RelativeFilename[0] == TEXT('\n')))
+																		   {
+																			   RelativeFilename.RightChopInline(1);
+																		   }
+																		   if (!RelativeFilename.IsEmpty())
+																		   {
+																			   CommittedFilesSet.Emplace(RelativeFilename);
+																		   }
+																	   },
+																	   InCommand.ResultInfo.ErrorMessages, '\0');
+			CommittedFiles = CommittedFilesSet.Array();
 		}
 
 		bool bUnpushedFiles;
@@ -380,9 +401,14 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 	return false;
 }
 
+void FGitCheckInWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitCheckInWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitMarkForAddWorker::GetName() const
@@ -420,9 +446,14 @@ bool FGitMarkForAddWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitMarkForAddWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitMarkForAddWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitDeleteWorker::GetName() const
@@ -460,9 +491,14 @@ bool FGitDeleteWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitDeleteWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitDeleteWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 
@@ -472,10 +508,16 @@ void GetMissingVsExistingFiles(const TArray<FString>& InFiles, TArray<FString>&
 	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
 	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
 
-	const TArray<FString> Files = (InFiles.Num() > 0) ? (InFiles) : (Provider.GetFilesInCache());
-
+	// For a full revert, only the files with local changes are of interest: all the others are already at their committed state
 	TArray<TSharedRef<ISourceControlState, ESPMode::ThreadSafe>> LocalStates;
-	Provider.GetState(Files, LocalStates, EStateCacheUsage::Use);
+	if (InFiles.Num() > 0)
+	{
+		Provider.GetState(InFiles, LocalStates, EStateCacheUsage::Use);
+	}
+	else
+	{
+		LocalStates = Provider.GetCachedStatesByCategory(EGitStateCategory::LocalChanges);
+	}
 	for (const auto& State : LocalStates)
 	{
 		if (FPaths::FileExists(State->GetFilename()))
@@ -609,9 +651,14 @@ bool FGitRevertWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitRevertWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitRevertWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitSyncWorker::GetName() const
@@ -644,9 +691,14 @@ bool FGitSyncWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitSyncWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitSyncWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitFetch::GetName() const
@@ -680,11 +732,9 @@ bool FGitFetchWorker::Execute(FGitSourceControlCommand& InCommand)
 	if (Operation->bUpdateStatus)
 	{
 		// Now update the status of all our files
-		const TArray<FString> ProjectDirs {FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
-										   FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath())};
 		TMap<FString, FGitSourceControlState> UpdatedStates;
-		InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
-																			  ProjectDirs, InCommand.ResultInfo.ErrorMessages, UpdatedStates);
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatusOfProject(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
+																					   InCommand.ResultInfo.ErrorMessages, UpdatedStates);
 		GitSourceControlUtils::RemoveRedundantErrors(InCommand, TEXT("' is outside repository"));
 		if (InCommand.bCommandSuccessful)
 		{
@@ -695,9 +745,14 @@ bool FGitFetchWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitFetchWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitFetchWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitUpdateStatusWorker::GetName() const
@@ -742,11 +797,9 @@ bool FGitUpdateStatusWorker::Execute(FGitSourceControlCommand& InCommand)
 	}
 	else
 	{
-		// no path provided: only update the status of assets in Content/ directory and also Config files
-		const TArray<FString> ProjectDirs {FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()), FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
-										   FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath())};
+		// no path provided: only update the status of assets in Content/ directory and also Config files (only the ones changed since the last time)
 		TMap<FString, FGitSourceControlState> UpdatedStates;
-		InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking, ProjectDirs, InCommand.ResultInfo.ErrorMessages, UpdatedStates);
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatusOfProject(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking, InCommand.ResultInfo.ErrorMessages, UpdatedStates);
 		GitSourceControlUtils::RemoveRedundantErrors(InCommand, TEXT("' is outside repository"));
 		if (InCommand.bCommandSuccessful)
 		{
@@ -761,9 +814,14 @@ bool FGitUpdateStatusWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitUpdateStatusWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitUpdateStatusWorker::UpdateStates() const
 {
-	bool bUpdated = GitSourceControlUtils::UpdateCachedStates(States);
+	bool bUpdated = GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 
 	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>( "GitSourceControl" );
 	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
@@ -817,9 +875,14 @@ bool FGitCopyWorker::Execute(FGitSourceControlCommand& InCommand)
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitCopyWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitCopyWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitResolveWorker::GetName() const
@@ -847,9 +910,14 @@ bool FGitResolveWorker::Execute( class FGitSourceControlCommand& InCommand )
 	return InCommand.bCommandSuccessful;
 }
 
+void FGitResolveWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitResolveWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 FName FGitMoveToChangelistWorker::GetName() const
@@ -857,9 +925,14 @@ FName FGitMoveToChangelistWorker::GetName() const
 	return "MoveToChangelist";
 }
 
+void FGitMoveToChangelistWorker::PrepareStates()
+{
+	GitSourceControlUtils::PrepareCachedStates(States, PreparedStates);
+}
+
 bool FGitMoveToChangelistWorker::UpdateStates() const
 {
-	return true;
+	return GitSourceControlUtils::UpdateCachedStates(PreparedStates);
 }
 
 bool FGitMoveToChangelistWorker::Execute(FGitSourceControlCommand& InCommand)
@@ -881,8 +954,11 @@ bool FGitMoveToChangelistWorker::Execute(FGitSourceControlCommand& InCommand)
 	
 	if (bResult)
 	{
-		TMap<FString, FGitSourceControlState> DummyStates;
-		GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking, InCommand.Files, InCommand.ResultInfo.InfoMessages, DummyStates);
+		TMap<FString, FGitSourceControlState> UpdatedStates;
+		if (GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking, InCommand.Files, InCommand.ResultInfo.InfoMessages, UpdatedStates))
+		{
+			GitSourceControlUtils::CollectNewStates(UpdatedStates, States);
+		}
 	}
 	return bResult;
 }
@@ -8,6 +8,7 @@
 #include "CoreMinimal.h"
 #include "IGitSourceControlWorker.h"
 #include "GitSourceControlState.h"
+#include "GitSourceControlUtils.h"
 
 #include "ISourceControlOperation.h"
 
@@ -48,10 +49,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Commit (check-in) a set of files to the local depot. */
@@ -62,10 +67,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Add an untracked file to revision control (so only a subset of the git add command). */
@@ -76,10 +85,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Delete a file and remove it from revision control. */
@@ -90,10 +103,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Revert any change to a file to its state on the local depot. */
@@ -104,10 +121,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Git pull --rebase to update branch from its configured remote */
@@ -118,10 +139,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Get revision control status of files on local working copy. */
@@ -132,12 +157,16 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 public:
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
 
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
+
 	/** Map of filenames to history */
 	TMap<FString, TGitSourceControlHistory> Histories;
 };
@@ -150,10 +179,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** git add to mark a conflict as resolved */
@@ -163,10 +196,14 @@ public:
 	virtual ~FGitResolveWorker() {}
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 /** Git push to publish branch for its configured remote */
@@ -177,10 +214,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 class FGitMoveToChangelistWorker : public IGitSourceControlWorker
@@ -190,10 +231,14 @@ public:
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual void PrepareStates() override;
 	virtual bool UpdateStates() const override;
 	
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
+
+	/** Temporary states compared to the cache on the worker thread (see GitSourceControlUtils::PrepareCachedStates()) */
+	FGitCachedStatesUpdate PreparedStates;
 };
 
 class FGitUpdateStagingWorker: public IGitSourceControlWorker
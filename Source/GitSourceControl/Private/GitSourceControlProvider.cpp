@@ -6,9 +6,13 @@
 #include "GitSourceControlProvider.h"
 
 #include "GitMessageLog.h"
+#include "GitSourceControlCatFile.h"
+#include "GitSourceControlExecutor.h"
+#include "GitSourceControlIndex.h"
+#include "GitSourceControlRefs.h"
 #include "GitSourceControlState.h"
+#include "GitSourceControlWorkingTree.h"
 #include "Misc/Paths.h"
-#include "Misc/QueuedThreadPool.h"
 #include "GitSourceControlCommand.h"
 #include "ISourceControlModule.h"
 #include "GitSourceControlModule.h"
@@ -22,11 +26,14 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Async/Async.h"
 #include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/Event.h"
 #include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/App.h"
 #include "Misc/EngineVersionComparison.h"
 #include "Misc/MessageDialog.h"
+#include "Misc/ScopeRWLock.h"
 #include "UObject/ObjectSaveContext.h"
 #include "UObject/Package.h"
 
@@ -34,6 +41,21 @@
 
 static FName ProviderName("Git LFS 2");
 
+/** Delay during which the asynchronous status updates are merged before running a single "git status" (in seconds) */
+static const double UpdateStatusCoalescingDelay = 0.1;
+
+/** While the read lane of the executor is saturated, keep merging the status requests, up to this delay in seconds */
+static const double MaxUpdateStatusCoalescingDelay = 1.0;
+
+/** Interval between two updates of the progress dialog while waiting for a synchronous command (in milliseconds) */
+static const uint32 SynchronousProgressIntervalMs = 200;
+
+static TAutoConsoleVariable<float> CVarTickBudgetMs(
+	TEXT("GitSourceControl.TickBudgetMs"),
+	2.0f,
+	TEXT("Time budget of each frame to process the completed revision control commands (state updates and completion delegates), in milliseconds.\n")
+	TEXT("At least one command is processed each frame. 0 processes all the completed commands."));
+
 void FGitSourceControlProvider::Init(bool bForceConnection)
 {
 	// Init() is called multiple times at startup: do not check git each time
@@ -113,6 +135,12 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 		bGitRepositoryFound = false;
 		return;
 	}
+	GitSourceControlUtils::FindGitCapabilities(PathToGitBinary, &GitVersion);
+
+	// Invalidate the branch names and the other values derived from the references of the repository when they change
+	FGitRefsWatcher::Get().Start(PathToRepositoryRoot);
+	// Collect the paths changed in the project directories, so that the next status of the whole project only asks Git about them
+	FGitWorkingTreeWatcher::Get().Start(PathToRepositoryRoot);
 
 	TUniqueFunction<void()> InitFunc = [this]()
 	{
@@ -129,15 +157,16 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 
 		// Get user name & email (of the repository, else from the global Git config)
 		GitSourceControlUtils::GetUserConfig(PathToGitBinary, PathToRepositoryRoot, UserName, UserEmail);
+
+		UpdateStatusAcceleration();
 		
 		TMap<FString, FGitSourceControlState> States;
 		auto ConditionalRepoInit = [this, &States]()
 		{
-			if (!GitSourceControlUtils::GetBranchName(PathToGitBinary, PathToRepositoryRoot, BranchName))
+			if (GetBranchName().IsEmpty())
 			{
 				return false;
 			}
-			GitSourceControlUtils::GetRemoteBranchName(PathToGitBinary, PathToRepositoryRoot, RemoteBranchName);
 			GitSourceControlUtils::GetRemoteUrl(PathToGitBinary, PathToRepositoryRoot, RemoteUrl);
 			const TArray<FString> Files{TEXT("*.uasset"), TEXT("*.umap")};
 			TArray<FString> LockableErrorMessages;
@@ -148,11 +177,8 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 					UE_LOG(LogSourceControl, Error, TEXT("%s"), *ErrorMessage);
 				}
 			}
-			const TArray<FString> ProjectDirs{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),
-											  FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
-											  FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath())};
 			TArray<FString> StatusErrorMessages;
-			if (!GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, PathToRepositoryRoot, bUsingGitLfsLocking, ProjectDirs, StatusErrorMessages, States))
+			if (!GitSourceControlUtils::RunUpdateStatusOfProject(PathToGitBinary, PathToRepositoryRoot, bUsingGitLfsLocking, StatusErrorMessages, States))
 			{
 				return false;
 			}
@@ -206,6 +232,69 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 	}
 }
 
+void FGitSourceControlProvider::UpdateStatusAcceleration()
+{
+	FString AvailableOptions;
+	FString AvailableDescription;
+	{
+		// Detect without any option
+		FScopeLock Lock(&StatusAccelerationCriticalSection);
+		StatusAccelerationOptions.Empty();
+	}
+	// Only install the fsmonitor-watchman hook when asked to
+	const bool bUsingStatusAcceleration = FGitSourceControlModule::Get().AccessSettings().IsUsingStatusAcceleration();
+	GitSourceControlUtils::FindStatusAcceleration(PathToGitBinary, PathToRepositoryRoot, GitVersion, bUsingStatusAcceleration, AvailableOptions, AvailableDescription);
+
+	{
+		FScopeLock Lock(&StatusAccelerationCriticalSection);
+		AvailableStatusAcceleration = AvailableDescription;
+		StatusAccelerationOptions = bUsingStatusAcceleration ? AvailableOptions : FString();
+	}
+
+	if (bUsingStatusAcceleration && !AvailableOptions.IsEmpty())
+	{
+		// The fsmonitor and untracked cache extensions are added to the index the next time it is written: "git status" runs with "--no-optional-locks"
+		TArray<FString> Results;
+		TArray<FString> ErrorMessages;
+		const TArray<FString> Parameters{TEXT("-q"), TEXT("--refresh")};
+		GitSourceControlUtils::RunCommand(TEXT("update-index"), PathToGitBinary, PathToRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+	}
+}
+
+void FGitSourceControlProvider::SetBranchStatus(const FGitBranchStatus& InBranchStatus)
+{
+	FScopeLock Lock(&BranchStatusCriticalSection);
+	BranchStatus = InBranchStatus;
+}
+
+FString FGitSourceControlProvider::GetStatusAccelerationOptions() const
+{
+	FScopeLock Lock(&StatusAccelerationCriticalSection);
+	return StatusAccelerationOptions;
+}
+
+void FGitSourceControlProvider::RecordFullStatusTime(const bool bInAccelerated, const double InSeconds)
+{
+	FScopeLock Lock(&StatusAccelerationCriticalSection);
+	FullStatusSeconds[bInAccelerated ? 1 : 0] += InSeconds;
+	NumFullStatuses[bInAccelerated ? 1 : 0]++;
+	UE_LOG(LogSourceControl, Log, TEXT("Full status of the project in %.0fms (%s)"), InSeconds * 1000.0, bInAccelerated ? TEXT("accelerated") : TEXT("not accelerated"));
+}
+
+FText FGitSourceControlProvider::GetStatusAccelerationText() const
+{
+	FScopeLock Lock(&StatusAccelerationCriticalSection);
+	auto AverageTime = [this](const int32 InIndex)
+	{
+		return (NumFullStatuses[InIndex] > 0) ? FText::Format(LOCTEXT("StatusAverageTime", "{0}ms"), FText::AsNumber(FMath::RoundToInt(FullStatusSeconds[InIndex] * 1000.0 / NumFullStatuses[InIndex]))) : LOCTEXT("StatusNotMeasured", "not measured");
+	};
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Available"), AvailableStatusAcceleration.IsEmpty() ? LOCTEXT("NoStatusAcceleration", "none available") : FText::FromString(AvailableStatusAcceleration));
+	Args.Add(TEXT("Before"), AverageTime(0));
+	Args.Add(TEXT("After"), AverageTime(1));
+	return FText::Format(LOCTEXT("StatusAccelerationText", "{Available}. Full status: {Before} without, {After} with"), Args);
+}
+
 void FGitSourceControlProvider::SetLastErrors(const TArray<FText>& InErrors)
 {
 
@@ -229,7 +318,44 @@ int32 FGitSourceControlProvider::GetNumLastErrors() const
 void FGitSourceControlProvider::Close()
 {
 	// clear the cache
-	StateCache.Empty();
+	for (FGitStateCacheShard& Shard : StateCacheShards)
+	{
+		FRWScopeLock Lock(Shard.Lock, SLT_Write);
+		Shard.States.Empty();
+	}
+	{
+		FRWScopeLock Lock(StateCategoryIndicesLock, SLT_Write);
+		for (auto& StateCategoryIndex : StateCategoryIndices)
+		{
+			StateCategoryIndex.Empty();
+		}
+	}
+	IncrementStateCacheGeneration();
+	// Abandon the commands waiting for a lane and stop the threads of the executor
+	FGitSourceControlExecutor::Get().Shutdown();
+	// Stop the persistent "cat-file" processes
+	FGitCatFilePool::Get().Shutdown();
+	FGitIndexCache::Get().Empty();
+	FGitRefsWatcher::Get().Stop();
+	FGitWorkingTreeWatcher::Get().Stop();
+	SetBranchStatus(FGitBranchStatus());
+	for (const auto& Pending : PendingUpdateStatuses)
+	{
+		for (const auto& Waiter : Pending.Value.Waiters)
+		{
+			Waiter.Value.ExecuteIfBound(Waiter.Key, ECommandResult::Cancelled);
+		}
+	}
+	PendingUpdateStatuses.Empty();
+	{
+		FScopeLock Lock(&RefsCachesCriticalSection);
+		RefsCachesGeneration = INDEX_NONE;
+		RefsCachesInputsVersion++;
+		BranchName.Empty();
+		RemoteBranchName.Empty();
+		StatusBranchNames.Empty();
+		StatusBranchIndices.Empty();
+	}
 	// Remove all extensions to the "Revision Control" menu in the Editor Toolbar
 	GitSourceControlMenu.Unregister();
 
@@ -239,21 +365,134 @@ void FGitSourceControlProvider::Close()
 	UserEmail.Empty();
 }
 
-TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(const FString& Filename)
+FStringView FGitStateCacheKeyFuncs::GetSetKey(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState)
 {
-	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = StateCache.Find(Filename);
-	if (State != NULL)
+	return InState->LocalFilename;
+}
+
+bool FGitStateCacheKeyFuncs::Matches(FStringView A, FStringView B)
+{
+	return A.Equals(B, ESearchCase::IgnoreCase);
+}
+
+uint32 FGitStateCacheKeyFuncs::GetKeyHash(FStringView InKey)
+{
+	return FCrc::Strihash_DEPRECATED(InKey.Len(), InKey.GetData());
+}
+
+TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(FStringView Filename)
+{
+	// Hash the filename only once, to find it or to add it
+	const uint32 KeyHash = FGitStateCacheKeyFuncs::GetKeyHash(Filename);
+	FGitStateCacheShard& Shard = GetStateCacheShard(KeyHash);
+	{
+		FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+		if (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = Shard.States.FindByHash(KeyHash, Filename))
+		{
+			// found cached item
+			return (*State);
+		}
+	}
+
+	// cache an unknown state for this item, unless another thread just did
+	FRWScopeLock Lock(Shard.Lock, SLT_Write);
+	if (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = Shard.States.FindByHash(KeyHash, Filename))
 	{
-		// found cached item
 		return (*State);
 	}
-	else
+	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> NewState = MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(FString(Filename));
+	Shard.States.AddByHash(KeyHash, NewState);
+	return NewState;
+}
+
+TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::FindStateInternal(FStringView Filename) const
+{
+	const uint32 KeyHash = FGitStateCacheKeyFuncs::GetKeyHash(Filename);
+	const FGitStateCacheShard& Shard = GetStateCacheShard(KeyHash);
+	FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+	if (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = Shard.States.FindByHash(KeyHash, Filename))
 	{
-		// cache an unknown state for this item
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> NewState = MakeShareable( new FGitSourceControlState(Filename) );
-		StateCache.Add(Filename, NewState);
-		return NewState;
+		return *State;
+	}
+	return nullptr;
+}
+
+TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> FGitSourceControlProvider::GetAllStatesInternal() const
+{
+	TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> States;
+	for (const FGitStateCacheShard& Shard : StateCacheShards)
+	{
+		FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+		States.Reserve(States.Num() + Shard.States.Num());
+		for (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State : Shard.States)
+		{
+			States.Add(State);
+		}
+	}
+	return States;
+}
+
+void FGitSourceControlProvider::RenameStateInternal(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState, const FString& InNewFilename)
+{
+	// The filename is the key of the state in the cache and in its indices
+	RemoveStateCategories(InState);
+	bool bWasCached = false;
+	{
+		FGitStateCacheShard& Shard = GetStateCacheShard(FGitStateCacheKeyFuncs::GetKeyHash(InState->LocalFilename));
+		FRWScopeLock Lock(Shard.Lock, SLT_Write);
+		bWasCached = (Shard.States.Remove(InState->LocalFilename) > 0);
+		InState->LocalFilename = InNewFilename;
+	}
+	if (bWasCached)
+	{
+		{
+			FGitStateCacheShard& Shard = GetStateCacheShard(FGitStateCacheKeyFuncs::GetKeyHash(InState->LocalFilename));
+			FRWScopeLock Lock(Shard.Lock, SLT_Write);
+			Shard.States.Add(InState);
+		}
+		UpdateStateCategories(InState);
+	}
+	IncrementStateCacheGeneration();
+}
+
+void FGitSourceControlProvider::UpdateStateCategories(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState)
+{
+	const uint32 Categories = InState->GetCategories();
+	const uint32 ChangedCategories = Categories ^ InState->IndexedCategories;
+	if (ChangedCategories == 0)
+	{
+		return;
+	}
+	FRWScopeLock Lock(StateCategoryIndicesLock, SLT_Write);
+	for (int32 Category = 0; ChangedCategories != 0 && Category < EGitStateCategory::Num; Category++)
+	{
+		const uint32 CategoryBit = EGitStateCategory::Bit((EGitStateCategory::Type)Category);
+		if (ChangedCategories & CategoryBit)
+		{
+			if (Categories & CategoryBit)
+			{
+				StateCategoryIndices[Category].Add(InState);
+			}
+			else
+			{
+				StateCategoryIndices[Category].Remove(InState->LocalFilename);
+			}
+		}
+	}
+	InState->IndexedCategories = (uint8)Categories;
+}
+
+void FGitSourceControlProvider::RemoveStateCategories(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState)
+{
+	FRWScopeLock Lock(StateCategoryIndicesLock, SLT_Write);
+	for (int32 Category = 0; InState->IndexedCategories != 0 && Category < EGitStateCategory::Num; Category++)
+	{
+		if (InState->IndexedCategories & EGitStateCategory::Bit((EGitStateCategory::Type)Category))
+		{
+			StateCategoryIndices[Category].Remove(InState->LocalFilename);
+		}
 	}
+	InState->IndexedCategories = 0;
 }
 
 TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(const FGitSourceControlChangelist& InChangelist)
@@ -281,7 +520,7 @@ FText FGitSourceControlProvider::GetStatusText() const
 	Args.Add( TEXT("RemoteUrl"), FText::FromString(RemoteUrl) );
 	Args.Add( TEXT("UserName"), FText::FromString(UserName) );
 	Args.Add( TEXT("UserEmail"), FText::FromString(UserEmail) );
-	Args.Add( TEXT("BranchName"), FText::FromString(BranchName) );
+	Args.Add( TEXT("BranchName"), FText::FromString(GetBranchName()) );
 	Args.Add( TEXT("CommitId"), FText::FromString(CommitId.Left(8)) );
 	Args.Add( TEXT("CommitSummary"), FText::FromString(CommitSummary) );
 
@@ -327,7 +566,7 @@ ECommandResult::Type FGitSourceControlProvider::GetState( const TArray<FString>&
 	if (InStateCacheUsage == EStateCacheUsage::ForceUpdate)
 	{
 		TArray<FString> ForceUpdate;
-		for (FString Path : InFiles)
+		for (const FString& Path : SourceControlHelpers::AbsoluteFilenames(InFiles))
 		{
 			// Remove the path from the cache, so it's not ignored the next time we force check.
 			// If the file isn't in the cache, force update it now.
@@ -338,7 +577,33 @@ ECommandResult::Type FGitSourceControlProvider::GetState( const TArray<FString>&
 		}
 		if (ForceUpdate.Num() > 0)
 		{
-			Execute(ISourceControlOperation::Create<FUpdateStatus>(), ForceUpdate);
+			// Wait for the status updates already queued for some of these files instead of running them twice
+			IssuePendingUpdateStatuses(true);
+			TArray<FString> AbsoluteForceUpdate = MoveTemp(ForceUpdate);
+			const FString RepositoryRoot = GitSourceControlUtils::ChangeRepositoryRootIfSubmodule(AbsoluteForceUpdate, PathToRepositoryRoot);
+			TArray<FGitSourceControlCommand*> QueuedCommands;
+			RemoveFilesOfQueuedUpdateStatuses(RepositoryRoot, AbsoluteForceUpdate, QueuedCommands);
+			// Keep the ids of these commands, since Tick() deletes them once completed (and their addresses can be reused)
+			TArray<uint32> QueuedCommandIds;
+			for (const FGitSourceControlCommand* QueuedCommand : QueuedCommands)
+			{
+				QueuedCommandIds.Add(QueuedCommand->CommandId);
+			}
+			if (AbsoluteForceUpdate.Num() > 0)
+			{
+				Execute(ISourceControlOperation::Create<FUpdateStatus>(), AbsoluteForceUpdate);
+			}
+			for (const uint32 QueuedCommandId : QueuedCommandIds)
+			{
+				while (FGitSourceControlCommand* PendingCommand = FindPendingCommand(QueuedCommandId))
+				{
+					if (!PendingCommand->bExecuteProcessed)
+					{
+						PendingCommand->CompletionEvent->Wait(SynchronousProgressIntervalMs);
+					}
+					Tick();
+				}
+			}
 		}
 	}
 
@@ -369,12 +634,13 @@ ECommandResult::Type FGitSourceControlProvider::GetState(const TArray<FSourceCon
 }
 #endif
 
+// The predicate of the editor is opaque, so this still scans the whole cache: the plugin itself uses GetCachedStatesByCategory()
 TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStateByPredicate(TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const
 {
 	TArray<FSourceControlStateRef> Result;
-	for (const auto& CacheItem : StateCache)
+	// The predicate is called without holding the locks of the cache, since it can call back the provider
+	for (const FSourceControlStateRef State : GetAllStatesInternal())
 	{
-		const FSourceControlStateRef& State = CacheItem.Value;
 		if (Predicate(State))
 		{
 			Result.Add(State);
@@ -383,32 +649,119 @@ TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStateByPredic
 	return Result;
 }
 
+TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStatesByCategory(const uint32 InCategories) const
+{
+	return GetCachedStatesByCategory(InCategories, [](const FSourceControlStateRef&) { return true; });
+}
+
+TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStatesByCategory(const uint32 InCategories, TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const
+{
+	TArray<FSourceControlStateRef> States;
+	{
+		FRWScopeLock Lock(StateCategoryIndicesLock, SLT_ReadOnly);
+		for (int32 Category = 0; Category < EGitStateCategory::Num; Category++)
+		{
+			const uint32 CategoryBit = EGitStateCategory::Bit((EGitStateCategory::Type)Category);
+			if ((InCategories & CategoryBit) == 0)
+			{
+				continue;
+			}
+			// A state in several of the requested categories is only returned for the first one
+			const uint32 PreviousCategories = InCategories & (CategoryBit - 1);
+			for (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State : StateCategoryIndices[Category])
+			{
+				if ((State->IndexedCategories & PreviousCategories) == 0)
+				{
+					States.Add(State);
+				}
+			}
+		}
+	}
+	// The predicate is called without holding the lock of the indices, since it can call back the provider
+	return States.FilterByPredicate(Predicate);
+}
+
 bool FGitSourceControlProvider::RemoveFileFromCache(const FString& Filename)
 {
-	return StateCache.Remove(Filename) > 0;
+	const TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> State = FindStateInternal(Filename);
+	if (!State.IsValid())
+	{
+		return false;
+	}
+	RemoveStateCategories(State.ToSharedRef());
+	FGitStateCacheShard& Shard = GetStateCacheShard(FGitStateCacheKeyFuncs::GetKeyHash(Filename));
+	FRWScopeLock Lock(Shard.Lock, SLT_Write);
+	IncrementStateCacheGeneration();
+	return Shard.States.Remove(Filename) > 0;
 }
 
 bool FGitSourceControlProvider::AddFileToIgnoreForceCache(const FString& Filename)
 {
-	return IgnoreForceCache.Add(Filename) > 0;
+	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = GetStateInternal(Filename);
+	const bool bAdded = !State->bIgnoreForceUpdate;
+	State->bIgnoreForceUpdate = true;
+	return bAdded;
 }
 
 bool FGitSourceControlProvider::RemoveFileFromIgnoreForceCache(const FString& Filename)
 {
-	return IgnoreForceCache.Remove(Filename) > 0;
+	const TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> State = FindStateInternal(Filename);
+	if (!State.IsValid() || !State->bIgnoreForceUpdate)
+	{
+		return false;
+	}
+	State->bIgnoreForceUpdate = false;
+	return true;
 }
 
 /** Get files in cache */
 TArray<FString> FGitSourceControlProvider::GetFilesInCache()
 {
 	TArray<FString> Files;
-	for (const auto& State : StateCache)
+	for (const FGitStateCacheShard& Shard : StateCacheShards)
 	{
-		Files.Add(State.Key);
+		FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+		Files.Reserve(Files.Num() + Shard.States.Num());
+		for (const auto& State : Shard.States)
+		{
+			Files.Add(State->LocalFilename);
+		}
 	}
 	return Files;
 }
 
+void FGitSourceControlProvider::LogStateCacheMemoryReport() const
+{
+	const TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> States = GetAllStatesInternal();
+	const int32 NumStates = States.Num();
+	// The states are allocated together with their reference counters (see GetStateInternal())
+	const SIZE_T StatesSize = NumStates * (sizeof(FGitSourceControlState) + sizeof(void*) + 2 * sizeof(int32));
+	SIZE_T HeapSize = 0;
+	int32 NumDetails = 0;
+	int32 NumRevisions = 0;
+	for (const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State : States)
+	{
+		HeapSize += State->GetAllocatedSize();
+		NumRevisions += State->History.Num();
+		if (State->HasDetails())
+		{
+			NumDetails++;
+		}
+	}
+	SIZE_T CacheSize = 0;
+	for (const FGitStateCacheShard& Shard : StateCacheShards)
+	{
+		FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+		CacheSize += Shard.States.GetAllocatedSize();
+	}
+	const SIZE_T TotalSize = StatesSize + HeapSize + CacheSize;
+
+	UE_LOG(LogSourceControl, Display, TEXT("State cache: %d files, %d with details, %d revisions in their history"), NumStates, NumDetails, NumRevisions);
+	UE_LOG(LogSourceControl, Display, TEXT("  states: %llu bytes (%llu bytes each), filenames and other allocations: %llu bytes, hash set: %llu bytes"),
+		(uint64)StatesSize, (uint64)sizeof(FGitSourceControlState), (uint64)HeapSize, (uint64)CacheSize);
+	UE_LOG(LogSourceControl, Display, TEXT("  total: %llu KiB, %llu bytes per file"), (uint64)(TotalSize / 1024), (uint64)(NumStates > 0 ? TotalSize / NumStates : 0));
+}
+
 FDelegateHandle FGitSourceControlProvider::RegisterSourceControlStateChanged_Handle( const FSourceControlStateChanged::FDelegate& SourceControlStateChanged )
 {
 	return OnSourceControlStateChanged.Add( SourceControlStateChanged );
@@ -450,10 +803,26 @@ ECommandResult::Type FGitSourceControlProvider::Execute( const FSourceControlOpe
 		return ECommandResult::Failed;
 	}
 
+	// Merge the asynchronous status updates requested in a short time (by the Content Browser, the asset tooltips...) into a single "git status"
+	if (InConcurrency == EConcurrency::Asynchronous
+#if !UE_VERSION_OLDER_THAN(5, 0, 0)
+		&& !InChangelist.IsValid()
+#endif
+		&& CoalesceUpdateStatus(InOperation, AbsoluteFiles, InOperationCompleteDelegate))
+	{
+		return ECommandResult::Succeeded;
+	}
+
 	FGitSourceControlCommand* Command = new FGitSourceControlCommand(InOperation, Worker.ToSharedRef());
 	Command->UpdateRepositoryRootIfSubmodule(AbsoluteFiles);
 	Command->Files = AbsoluteFiles;
 	Command->OperationCompleteDelegate = InOperationCompleteDelegate;
+	Command->Priority = GetWorkerPriority(InOperation->GetName());
+	if ((Command->Priority == EGitCommandPriority::Foreground) && (InOperation->GetName() == "UpdateStatus") && AbsoluteFiles.Num() == 0)
+	{
+		// A status of the whole working copy is a refresh the user is not waiting for
+		Command->Priority = EGitCommandPriority::Background;
+	}
 
 	TSharedPtr<FGitSourceControlChangelist, ESPMode::ThreadSafe> ChangelistPtr = StaticCastSharedPtr<FGitSourceControlChangelist>(InChangelist);
 	Command->Changelist = ChangelistPtr ? ChangelistPtr.ToSharedRef().Get() : FGitSourceControlChangelist();
@@ -541,12 +910,30 @@ bool FGitSourceControlProvider::UsesFileRevisions() const
 
 TOptional<bool> FGitSourceControlProvider::IsAtLatestRevision() const
 {
-	return TOptional<bool>();
+	FScopeLock Lock(&BranchStatusCriticalSection);
+	if (BranchStatus.Behind == INDEX_NONE)
+	{
+		return TOptional<bool>();
+	}
+	return BranchStatus.Behind == 0;
 }
 
 TOptional<int> FGitSourceControlProvider::GetNumLocalChanges() const
 {
-	return TOptional<int>();
+	if (!bGitRepositoryFound)
+	{
+		return TOptional<int>();
+	}
+	// The changelists are kept up to date with every status (see GitSourceControlUtils::UpdateCachedStates())
+	int32 NumLocalChanges = 0;
+	for (const FGitSourceControlChangelist* Changelist : { &FGitSourceControlChangelist::StagedChangelist, &FGitSourceControlChangelist::WorkingChangelist })
+	{
+		if (const TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe>* ChangelistState = ChangelistsStateCache.Find(*Changelist))
+		{
+			NumLocalChanges += (*ChangelistState)->Files.Num();
+		}
+	}
+	return NumLocalChanges;
 }
 #endif
 
@@ -580,7 +967,7 @@ TMap<ISourceControlProvider::EStatus, FString> FGitSourceControlProvider::GetSta
 	Result.Add(EStatus::User, UserName);
 	Result.Add(EStatus::Repository, PathToRepositoryRoot);
 	Result.Add(EStatus::Remote, RemoteUrl);
-	Result.Add(EStatus::Branch, BranchName);
+	Result.Add(EStatus::Branch, GetBranchName());
 	Result.Add(EStatus::Email, UserEmail);
 	return Result;
 }
@@ -597,9 +984,16 @@ TSharedPtr<IGitSourceControlWorker, ESPMode::ThreadSafe> FGitSourceControlProvid
 	return nullptr;
 }
 
-void FGitSourceControlProvider::RegisterWorker( const FName& InName, const FGetGitSourceControlWorker& InDelegate )
+void FGitSourceControlProvider::RegisterWorker( const FName& InName, const FGetGitSourceControlWorker& InDelegate, const EGitCommandPriority::Type InPriority )
 {
 	WorkersMap.Add( InName, InDelegate );
+	WorkerPriorities.Add( InName, InPriority );
+}
+
+EGitCommandPriority::Type FGitSourceControlProvider::GetWorkerPriority(const FName& InOperationName) const
+{
+	const EGitCommandPriority::Type* Priority = WorkerPriorities.Find(InOperationName);
+	return Priority ? *Priority : EGitCommandPriority::Foreground;
 }
 
 void FGitSourceControlProvider::OutputCommandMessages(const FGitSourceControlCommand& InCommand) const
@@ -627,8 +1021,125 @@ void FGitSourceControlProvider::UpdateRepositoryStatus(const class FGitSourceCon
 	}
 }
 
+bool FGitSourceControlProvider::CoalesceUpdateStatus(const FSourceControlOperationRef& InOperation, const TArray<FString>& InAbsoluteFiles, const FSourceControlOperationComplete& InOperationCompleteDelegate)
+{
+	if (InOperation->GetName() != "UpdateStatus" || InAbsoluteFiles.Num() == 0)
+	{
+		return false;
+	}
+	// The history is stored in the operation itself, so it cannot be shared
+	if (StaticCastSharedRef<FUpdateStatus>(InOperation)->ShouldUpdateHistory())
+	{
+		return false;
+	}
+
+	TArray<FString> AbsoluteFiles = InAbsoluteFiles;
+	const FString RepositoryRoot = GitSourceControlUtils::ChangeRepositoryRootIfSubmodule(AbsoluteFiles, PathToRepositoryRoot);
+	FPendingUpdateStatus& Pending = PendingUpdateStatuses.FindOrAdd(RepositoryRoot);
+	if (Pending.Waiters.Num() == 0)
+	{
+		Pending.FirstRequestTime = FPlatformTime::Seconds();
+	}
+	Pending.Files.Append(AbsoluteFiles);
+	Pending.Waiters.Emplace(InOperation, InOperationCompleteDelegate);
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("CoalesceUpdateStatus(%d files): %d files pending for %s"), AbsoluteFiles.Num(), Pending.Files.Num(), *RepositoryRoot);
+
+	return true;
+}
+
+void FGitSourceControlProvider::IssuePendingUpdateStatuses(const bool bInForce)
+{
+	const double Now = FPlatformTime::Seconds();
+	// Back-pressure: no need to add more status commands behind the ones already waiting for the read lane
+	const double CoalescingDelay = (FGitSourceControlExecutor::Get().GetNumQueuedReads() > 0) ? MaxUpdateStatusCoalescingDelay : UpdateStatusCoalescingDelay;
+	for (auto It = PendingUpdateStatuses.CreateIterator(); It; ++It)
+	{
+		FPendingUpdateStatus& Pending = It.Value();
+		if (!bInForce && (Now - Pending.FirstRequestTime < CoalescingDelay))
+		{
+			continue;
+		}
+
+		TArray<FString> Files = Pending.Files.Array();
+		TArray<FString> FilesNotQueued = Files;
+		TArray<FGitSourceControlCommand*> QueuedCommands;
+		RemoveFilesOfQueuedUpdateStatuses(It.Key(), FilesNotQueued, QueuedCommands);
+		// All the files will be updated by a single command already in the queue: share its results, unless it started in the meantime
+		if (FilesNotQueued.Num() == 0 && QueuedCommands.Num() == 1 && QueuedCommands[0]->AppendCoalescedOperationsIfNotStarted(Pending.Waiters))
+		{
+			UE_LOG(LogSourceControl, Verbose, TEXT("IssuePendingUpdateStatuses: %d files already queued"), Pending.Files.Num());
+		}
+		else
+		{
+			// Keep the files already queued: the commands of the read lane run in parallel, so the waiters could otherwise complete
+			// before another command updated some of their files
+
+			TSharedPtr<IGitSourceControlWorker, ESPMode::ThreadSafe> Worker = CreateWorker("UpdateStatus");
+			FGitSourceControlCommand* Command = new FGitSourceControlCommand(ISourceControlOperation::Create<FUpdateStatus>(), Worker.ToSharedRef());
+			Command->PathToRepositoryRoot = It.Key();
+			Command->Priority = GetWorkerPriority("UpdateStatus");
+			Command->Files = MoveTemp(Files);
+			Command->CoalescedOperations = MoveTemp(Pending.Waiters);
+			Command->bAutoDelete = true;
+
+			UE_LOG(LogSourceControl, Verbose, TEXT("IssueAsynchronousCommand(UpdateStatus): %d files for %d requests"), Command->Files.Num(), Command->CoalescedOperations.Num());
+
+			IssueCommand(*Command);
+		}
+		It.RemoveCurrent();
+	}
+}
+
+void FGitSourceControlProvider::RemoveFilesOfQueuedUpdateStatuses(const FString& InRepositoryRoot, TArray<FString>& InOutAbsoluteFiles, TArray<FGitSourceControlCommand*>& OutCommands) const
+{
+	for (FGitSourceControlCommand* Command : CommandQueue)
+	{
+		if (InOutAbsoluteFiles.Num() == 0)
+		{
+			break;
+		}
+		if (Command->IsCanceled() || Command->Files.Num() == 0 || Command->Operation->GetName() != "UpdateStatus" || Command->PathToRepositoryRoot != InRepositoryRoot)
+		{
+			continue;
+		}
+		// A command already started may have read the status of the files before they were modified: decide under the lock the worker takes to start it
+		FScopeLock StartLock(&Command->StartCriticalSection);
+		if (Command->IsStarted())
+		{
+			continue;
+		}
+		const TSet<FString> CommandFiles(Command->Files);
+		if (InOutAbsoluteFiles.RemoveAll([&CommandFiles](const FString& InFile) { return CommandFiles.Contains(InFile); }) > 0)
+		{
+			OutCommands.Add(Command);
+		}
+	}
+}
+
+FGitSourceControlCommand* FGitSourceControlProvider::FindPendingCommand(const uint32 InCommandId) const
+{
+	for (FGitSourceControlCommand* Command : CommandQueue)
+	{
+		if (Command->CommandId == InCommandId)
+		{
+			return Command;
+		}
+	}
+	for (FGitSourceControlCommand* Command : CompletedCommands)
+	{
+		if (Command->CommandId == InCommandId)
+		{
+			return Command;
+		}
+	}
+	return nullptr;
+}
+
 void FGitSourceControlProvider::Tick()
 {
+	IssuePendingUpdateStatuses(false);
+
 #if !UE_VERSION_OLDER_THAN(5, 0, 0)
 	bool bStatesUpdated = false;
 #else
@@ -639,43 +1150,15 @@ void FGitSourceControlProvider::Tick()
 	}
 #endif
 
+	// Move the finished commands to the completion queue, in the order they were issued
 	for (int32 CommandIndex = 0; CommandIndex < CommandQueue.Num(); ++CommandIndex)
 	{
 		FGitSourceControlCommand& Command = *CommandQueue[CommandIndex];
 
 		if (Command.bExecuteProcessed)
 		{
-			// Remove command from the queue
-			CommandQueue.RemoveAt(CommandIndex);
-
-			if (!Command.IsCanceled())
-			{
-				// Update repository status on UpdateStatus operations
-				UpdateRepositoryStatus(Command);
-			}
-
-			// let command update the states of any files
-			bStatesUpdated |= Command.Worker->UpdateStates();
-
-			// dump any messages to output log
-			OutputCommandMessages(Command);
-
-			// run the completion delegate callback if we have one bound
-			if (!Command.IsCanceled())
-			{
-				Command.ReturnResults();
-			}
-
-			// commands that are left in the array during a tick need to be deleted
-			if(Command.bAutoDelete)
-			{
-				// Only delete commands that are not running 'synchronously'
-				delete &Command;
-			}
-
-			// only do one command per tick loop, as we dont want concurrent modification
-			// of the command queue (which can happen in the completion delegate)
-			break;
+			CommandQueue.RemoveAt(CommandIndex--);
+			CompletedCommands.Add(&Command);
 		}
 		else if (Command.bCancelled)
 		{
@@ -684,8 +1167,48 @@ void FGitSourceControlProvider::Tick()
 			Command.bAutoDelete = true;
 
 			Command.ReturnResults();
+		}
+	}
+
+	// Drain the completion queue within the time budget of the frame, but always process at least one command.
+	// Each command is taken out of the queue before its completion delegate runs, since it can issue new commands, or even tick the provider again.
+	const double TickBudget = CVarTickBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 NumProcessed = 0; CompletedCommands.Num() > 0; ++NumProcessed)
+	{
+		if (NumProcessed > 0 && TickBudget > 0.0 && (FPlatformTime::Seconds() - StartTime) >= TickBudget)
+		{
+			UE_LOG(LogSourceControl, Verbose, TEXT("Tick: %d completed commands left for the next frame"), CompletedCommands.Num());
 			break;
 		}
+
+		FGitSourceControlCommand& Command = *CompletedCommands[0];
+		CompletedCommands.RemoveAt(0);
+
+		if (!Command.IsCanceled())
+		{
+			// Update repository status on UpdateStatus operations
+			UpdateRepositoryStatus(Command);
+		}
+
+		// let command update the states of any files
+		bStatesUpdated |= Command.Worker->UpdateStates();
+
+		// dump any messages to output log
+		OutputCommandMessages(Command);
+
+		// run the completion delegate callback if we have one bound
+		if (!Command.IsCanceled())
+		{
+			Command.ReturnResults();
+		}
+
+		// commands that are left in the array during a tick need to be deleted
+		if(Command.bAutoDelete)
+		{
+			// Only delete commands that are not running 'synchronously'
+			delete &Command;
+		}
 	}
 
 	if (bStatesUpdated)
@@ -744,8 +1267,6 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 		TaskText = FText::GetEmpty();
 	}
 
-	int i = 0;
-
 	// Display the progress dialog if a string was provided
 	{
 		// TODO: support cancellation?
@@ -755,20 +1276,24 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 		// Issue the command asynchronously...
 		IssueCommand( InCommand );
 
-		// ... then wait for its completion (thus making it synchronous)
-		while (!InCommand.IsCanceled() && CommandQueue.Contains(&InCommand))
+		// ... then wait for its completion (thus making it synchronous), woken up as soon as the worker thread is done with it
+		double LastProgressTime = FPlatformTime::Seconds();
+		while (!InCommand.IsCanceled() && IsCommandPending(&InCommand))
 		{
+			if (!InCommand.bExecuteProcessed)
+			{
+				InCommand.CompletionEvent->Wait(SynchronousProgressIntervalMs);
+			}
+
 			// Tick the command queue and update progress.
 			Tick();
 
-			if (i >= 20) {
+			const double Now = FPlatformTime::Seconds();
+			if (Now - LastProgressTime >= SynchronousProgressIntervalMs / 1000.0)
+			{
 				Progress.Tick();
-				i = 0;
+				LastProgressTime = Now;
 			}
-			i++;
-
-			// Sleep for a bit so we don't busy-wait so much.
-			FPlatformProcess::Sleep(0.01f);
 		}
 
 		if (InCommand.bCancelled)
@@ -797,11 +1322,12 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 
 ECommandResult::Type FGitSourceControlProvider::IssueCommand(FGitSourceControlCommand& InCommand, const bool bSynchronous)
 {
-	if (!bSynchronous && GThreadPool != nullptr)
+	InCommand.CommandId = NextCommandId++;
+	if (!bSynchronous)
 	{
 		// Queue this to our worker thread(s) for resolving.
 		// When asynchronous, any callback gets called from Tick().
-		GThreadPool->AddQueuedWork(&InCommand);
+		FGitSourceControlExecutor::Get().Submit(InCommand);
 		CommandQueue.Add(&InCommand);
 		return ECommandResult::Succeeded;
 	}
@@ -842,7 +1368,10 @@ bool FGitSourceControlProvider::QueryStateBranchConfig(const FString& ConfigSrc,
 
 void FGitSourceControlProvider::RegisterStateBranches(const TArray<FString>& BranchNames, const FString& ContentRootIn)
 {
+	FScopeLock Lock(&RefsCachesCriticalSection);
 	StatusBranchNamePatternsInternal = BranchNames;
+	RefsCachesGeneration = INDEX_NONE;
+	RefsCachesInputsVersion++;
 }
 
 int32 FGitSourceControlProvider::GetStateBranchIndex(const FString& StateBranchName) const
@@ -853,15 +1382,17 @@ int32 FGitSourceControlProvider::GetStateBranchIndex(const FString& StateBranchN
 
 	// Check if we are checking the index of the current branch
 	// UE uses FEngineVersion for the current branch name because of UEGames setup, but we want to handle otherwise for Git repos.
-	auto StatusBranchNames = GetStatusBranchNames();
-	if (StateBranchName == FEngineVersion::Current().GetBranch())
+	// Called for each asset by the Content Browser: only hash lookups in tables built when the references change
+	static const FString EngineBranchName = FEngineVersion::Current().GetBranch();
+	UpdateRefsCaches();
+	FScopeLock Lock(&RefsCachesCriticalSection);
+	if (StateBranchName == EngineBranchName)
 	{
-		const int32 CurrentBranchStatusIndex = StatusBranchNames.IndexOfByKey(BranchName);
-		const bool bCurrentBranchInStatusBranches = CurrentBranchStatusIndex != INDEX_NONE;
+		const int32* CurrentBranchStatusIndex = StatusBranchIndices.Find(BranchName);
 		// If the user's current branch is tracked as a status branch, give the proper index
-		if (bCurrentBranchInStatusBranches)
+		if (CurrentBranchStatusIndex)
 		{
-			return CurrentBranchStatusIndex;
+			return *CurrentBranchStatusIndex;
 		}
 		// If the current branch is not a status branch, make it the highest branch
 		// This is semantically correct, since if a branch is not marked as a status branch
@@ -873,29 +1404,92 @@ int32 FGitSourceControlProvider::GetStateBranchIndex(const FString& StateBranchN
 
 	// If we're not checking the current branch, then we don't need to do special handling.
 	// If it is not a status branch, there is no message
-	return StatusBranchNames.IndexOfByKey(StateBranchName);
+	const int32* StatusIndex = StatusBranchIndices.Find(StateBranchName);
+	return StatusIndex ? *StatusIndex : INDEX_NONE;
+}
+
+FString FGitSourceControlProvider::GetBranchName() const
+{
+	UpdateRefsCaches();
+	FScopeLock Lock(&RefsCachesCriticalSection);
+	return BranchName;
+}
+
+FString FGitSourceControlProvider::GetRemoteBranchName() const
+{
+	UpdateRefsCaches();
+	FScopeLock Lock(&RefsCachesCriticalSection);
+	return RemoteBranchName;
 }
 
 TArray<FString> FGitSourceControlProvider::GetStatusBranchNames() const
 {
-	TArray<FString> StatusBranches;
-	if(PathToGitBinary.IsEmpty() || PathToRepositoryRoot.IsEmpty())
-		return StatusBranches;
-	
-	for (int i = 0; i < StatusBranchNamePatternsInternal.Num(); i++)
+	UpdateRefsCaches();
+	FScopeLock Lock(&RefsCachesCriticalSection);
+	return StatusBranchNames;
+}
+
+void FGitSourceControlProvider::UpdateRefsCaches() const
+{
+	// Read the generation first, so that a change while reading the references invalidates what was read
+	const int32 RefsGeneration = FGitRefsWatcher::Get().GetGeneration();
+	FString GitBinary, RepositoryRoot;
+	TArray<FString> StatusBranchNamePatterns;
+	int32 InputsVersion;
 	{
-		TArray<FString> Matches;
-		bool bResult = GitSourceControlUtils::GetRemoteBranchesWildcard(PathToGitBinary, PathToRepositoryRoot, StatusBranchNamePatternsInternal[i], Matches);
-		if (bResult && Matches.Num() > 0)
+		FScopeLock Lock(&RefsCachesCriticalSection);
+		if (RefsCachesGeneration == RefsGeneration)
+		{
+			return;
+		}
+		GitBinary = PathToGitBinary;
+		RepositoryRoot = PathToRepositoryRoot;
+		StatusBranchNamePatterns = StatusBranchNamePatternsInternal;
+		InputsVersion = RefsCachesInputsVersion;
+	}
+
+	// Read the references without the lock, since they can fall back to running Git while the Content Browser waits on the game thread
+	FString NewBranchName;
+	FString NewRemoteBranchName;
+	TArray<FString> NewStatusBranchNames;
+	TMap<FString, int32> NewStatusBranchIndices;
+	if (!GitBinary.IsEmpty() && !RepositoryRoot.IsEmpty())
+	{
+		GitSourceControlUtils::ReadBranchName(GitBinary, RepositoryRoot, NewBranchName);
+		GitSourceControlUtils::ReadRemoteBranchName(GitBinary, RepositoryRoot, NewRemoteBranchName);
+		for (int i = 0; i < StatusBranchNamePatterns.Num(); i++)
+		{
+			TArray<FString> Matches;
+			bool bResult = GitSourceControlUtils::GetRemoteBranchesWildcard(GitBinary, RepositoryRoot, StatusBranchNamePatterns[i], Matches);
+			if (bResult && Matches.Num() > 0)
+			{
+				for (int j = 0; j < Matches.Num(); j++)
+				{
+					NewStatusBranchNames.Add(Matches[j].TrimStartAndEnd());
+				}
+			}
+		}
+		// Index of the first occurrence of each branch, like TArray::IndexOfByKey()
+		NewStatusBranchIndices.Reserve(NewStatusBranchNames.Num());
+		for (int32 Index = 0; Index < NewStatusBranchNames.Num(); Index++)
 		{
-			for (int j = 0; j < Matches.Num(); j++)
+			if (!NewStatusBranchIndices.Contains(NewStatusBranchNames[Index]))
 			{
-				StatusBranches.Add(Matches[j].TrimStartAndEnd());	
+				NewStatusBranchIndices.Add(NewStatusBranchNames[Index], Index);
 			}
 		}
 	}
-	
-	return StatusBranches;
+
+	FScopeLock Lock(&RefsCachesCriticalSection);
+	// Drop what was read if the patterns changed or the provider was closed meanwhile
+	if (InputsVersion == RefsCachesInputsVersion)
+	{
+		BranchName = MoveTemp(NewBranchName);
+		RemoteBranchName = MoveTemp(NewRemoteBranchName);
+		StatusBranchNames = MoveTemp(NewStatusBranchNames);
+		StatusBranchIndices = MoveTemp(NewStatusBranchIndices);
+		RefsCachesGeneration = (GitBinary.IsEmpty() || RepositoryRoot.IsEmpty()) ? INDEX_NONE : RefsGeneration;
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,451 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlRefs.h"
+
+#include "GitSourceControlUtils.h"
+#include "DirectoryWatcherModule.h"
+#include "HAL/PlatformFileManager.h"
+#include "IDirectoryWatcher.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Modules/ModuleManager.h"
+
+namespace GitRefsConstants
+{
+/** Maximum depth of symbolic references (same as Git) */
+const int32 MaxSymbolicRefDepth = 5;
+
+/** A packed-refs file written less than this many seconds before being read is read again next time, since it could be rewritten with the same size and timestamp */
+const double MinPackedRefsAgeToCache = 2.0;
+} // namespace GitRefsConstants
+
+namespace
+{
+
+bool IsCommitId(const FString& InValue)
+{
+	if (InValue.Len() != 40)
+	{
+		return false;
+	}
+	for (const TCHAR Char : InValue)
+	{
+		if (!FChar::IsHexDigit(Char))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// References specific to each worktree, stored in its own Git directory instead of the common directory
+bool IsPerWorktreeRef(const FString& InRefName)
+{
+	return (InRefName == TEXT("HEAD")) || InRefName.StartsWith(TEXT("refs/worktree/")) || InRefName.StartsWith(TEXT("refs/bisect/")) || InRefName.StartsWith(TEXT("refs/rewritten/"));
+}
+
+/** Content of a packed-refs file, kept as long as the file does not change */
+struct FPackedRefs
+{
+	int64 FileSize = 0;
+	FDateTime FileTime;
+	FDateTime ReadTime;
+
+	/** Map of the full reference names to their commit id */
+	TMap<FString, FString> Refs;
+};
+
+class FPackedRefsCache
+{
+public:
+	static FPackedRefsCache& Get()
+	{
+		static FPackedRefsCache Instance;
+		return Instance;
+	}
+
+	/** Get the up-to-date content of a packed-refs file (empty if there is none) */
+	TSharedRef<const FPackedRefs, ESPMode::ThreadSafe> GetPackedRefs(const FString& InFilename)
+	{
+		const FFileStatData StatData = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*InFilename);
+
+		FScopeLock ScopeLock(&CriticalSection);
+		TSharedPtr<const FPackedRefs, ESPMode::ThreadSafe>& PackedRefs = PackedRefsByFilename.FindOrAdd(InFilename);
+		if (PackedRefs.IsValid() && StatData.bIsValid && (PackedRefs->FileSize == StatData.FileSize) && (PackedRefs->FileTime == StatData.ModificationTime)
+			&& ((PackedRefs->ReadTime - PackedRefs->FileTime).GetTotalSeconds() >= GitRefsConstants::MinPackedRefsAgeToCache))
+		{
+			return PackedRefs.ToSharedRef();
+		}
+
+		TSharedRef<FPackedRefs, ESPMode::ThreadSafe> NewPackedRefs = MakeShared<FPackedRefs, ESPMode::ThreadSafe>();
+		NewPackedRefs->ReadTime = FDateTime::UtcNow();
+		TArray<FString> Lines;
+		if (StatData.bIsValid && FFileHelper::LoadFileToStringArray(Lines, *InFilename))
+		{
+			NewPackedRefs->FileSize = StatData.FileSize;
+			NewPackedRefs->FileTime = StatData.ModificationTime;
+			for (const FString& Line : Lines)
+			{
+				// "# pack-refs with: peeled fully-peeled sorted" header, "<commit id> <ref name>" and "^<commit id>" for the target of the annotated tag above
+				if ((Line.Len() > 41) && (Line[40] == TEXT(' ')) && !Line.StartsWith(TEXT("#")) && !Line.StartsWith(TEXT("^")))
+				{
+					NewPackedRefs->Refs.Add(Line.RightChop(41), Line.Left(40));
+				}
+			}
+		}
+		PackedRefs = NewPackedRefs;
+		return NewPackedRefs;
+	}
+
+private:
+	FCriticalSection CriticalSection;
+	TMap<FString, TSharedPtr<const FPackedRefs, ESPMode::ThreadSafe>> PackedRefsByFilename;
+};
+
+// Remove the quotes and the trailing comment of a config value
+FString ParseConfigValue(const FString& InValue)
+{
+	FString Value;
+	bool bInQuotes = false;
+	for (const TCHAR Char : InValue)
+	{
+		if (Char == TEXT('"'))
+		{
+			bInQuotes = !bInQuotes;
+		}
+		else if (!bInQuotes && ((Char == TEXT('#')) || (Char == TEXT(';'))))
+		{
+			break;
+		}
+		else
+		{
+			Value.AppendChar(Char);
+		}
+	}
+	return Value.TrimStartAndEnd();
+}
+
+/**
+ * Read some variables of a section of the repository config, ie. [branch "main"]
+ * @returns false if the config could not be read, or uses includes that could override the variables
+ */
+bool ReadConfigSection(const FString& InConfigFilename, const FString& InSection, const FString& InSubsection, TMap<FString, FString>& OutVariables)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *InConfigFilename))
+	{
+		return false;
+	}
+	bool bInSection = false;
+	for (const FString& RawLine : Lines)
+	{
+		const FString Line = RawLine.TrimStartAndEnd();
+		if (Line.StartsWith(TEXT("[")))
+		{
+			// [section "subsection"]: the section name is case-insensitive, the subsection is case-sensitive
+			if (Line.StartsWith(TEXT("[include"), ESearchCase::IgnoreCase))
+			{
+				return false;
+			}
+			FString Section, Subsection;
+			const FString Header = Line.Mid(1, Line.Find(TEXT("]")) - 1);
+			if (!Header.Split(TEXT(" "), &Section, &Subsection))
+			{
+				Section = Header;
+			}
+			Subsection = Subsection.TrimStartAndEnd().TrimQuotes();
+			bInSection = Section.Equals(InSection, ESearchCase::IgnoreCase) && Subsection.Equals(InSubsection, ESearchCase::CaseSensitive);
+		}
+		else if (bInSection)
+		{
+			FString Name, Value;
+			if (Line.Split(TEXT("="), &Name, &Value))
+			{
+				// The last value of a variable wins (variable names are case-insensitive)
+				OutVariables.Add(Name.TrimStartAndEnd().ToLower(), ParseConfigValue(Value));
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+FGitRefsReader::FGitRefsReader(const FString& InRepositoryRoot)
+{
+	if (GitSourceControlUtils::FindGitDirectory(InRepositoryRoot, GitDirectory))
+	{
+		// The Git directory of a linked worktree tells where the common directory of the repository is
+		FString CommonDirFileContent;
+		if (FFileHelper::LoadFileToString(CommonDirFileContent, *(GitDirectory / TEXT("commondir"))))
+		{
+			CommonDirectory = CommonDirFileContent.TrimStartAndEnd();
+			if (FPaths::IsRelative(CommonDirectory))
+			{
+				CommonDirectory = FPaths::ConvertRelativePathToFull(GitDirectory, CommonDirectory);
+			}
+		}
+		else
+		{
+			CommonDirectory = GitDirectory;
+		}
+	}
+}
+
+bool FGitRefsReader::ReadLooseRef(const FString& InRefName, FString& OutValue) const
+{
+	const FString& Directory = IsPerWorktreeRef(InRefName) ? GitDirectory : CommonDirectory;
+	if (!FFileHelper::LoadFileToString(OutValue, *(Directory / InRefName)))
+	{
+		return false;
+	}
+	OutValue.TrimStartAndEndInline();
+	return true;
+}
+
+bool FGitRefsReader::ReadPackedRef(const FString& InRefName, FString& OutCommitId) const
+{
+	const TSharedRef<const FPackedRefs, ESPMode::ThreadSafe> PackedRefs = FPackedRefsCache::Get().GetPackedRefs(CommonDirectory / TEXT("packed-refs"));
+	if (const FString* CommitId = PackedRefs->Refs.Find(InRefName))
+	{
+		OutCommitId = *CommitId;
+		return true;
+	}
+	return false;
+}
+
+bool FGitRefsReader::ReadHead(FString& OutSymbolicRef, FString& OutCommitId) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	FString Head;
+	if (!ReadLooseRef(TEXT("HEAD"), Head))
+	{
+		return false;
+	}
+	OutSymbolicRef.Empty();
+	OutCommitId.Empty();
+	if (Head.StartsWith(TEXT("ref:")))
+	{
+		OutSymbolicRef = Head.RightChop(4).TrimStart();
+		if (OutSymbolicRef == TEXT("refs/heads/.invalid"))
+		{
+			// Placeholder HEAD of a repository using the reftable backend
+			return false;
+		}
+		// The branch can be unborn (no commit yet)
+		ResolveRef(OutSymbolicRef, OutCommitId);
+		return true;
+	}
+	if (IsCommitId(Head))
+	{
+		OutCommitId = MoveTemp(Head);
+		return true;
+	}
+	return false;
+}
+
+bool FGitRefsReader::ResolveRef(const FString& InRefName, FString& OutCommitId) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	FString RefName = InRefName;
+	for (int32 Depth = 0; Depth < GitRefsConstants::MaxSymbolicRefDepth; Depth++)
+	{
+		FString Value;
+		if (ReadLooseRef(RefName, Value))
+		{
+			if (Value.StartsWith(TEXT("ref:")))
+			{
+				RefName = Value.RightChop(4).TrimStart();
+				continue;
+			}
+			if (IsCommitId(Value))
+			{
+				OutCommitId = MoveTemp(Value);
+				return true;
+			}
+			return false;
+		}
+		// Symbolic references are never packed
+		return ReadPackedRef(RefName, OutCommitId);
+	}
+	return false;
+}
+
+bool FGitRefsReader::GetUpstreamBranch(const FString& InBranchName, FString& OutUpstreamBranchName) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	const FString ConfigFilename = CommonDirectory / TEXT("config");
+	TMap<FString, FString> BranchConfig;
+	if (!ReadConfigSection(ConfigFilename, TEXT("branch"), InBranchName, BranchConfig))
+	{
+		return false;
+	}
+	const FString* Remote = BranchConfig.Find(TEXT("remote"));
+	const FString* Merge = BranchConfig.Find(TEXT("merge"));
+	if (!Remote || !Merge || !Merge->StartsWith(TEXT("refs/heads/")))
+	{
+		return false;
+	}
+	const FString MergeBranchName = Merge->RightChop(11);
+
+	FString CommitId;
+	if (*Remote == TEXT("."))
+	{
+		// Upstream is a local branch
+		OutUpstreamBranchName = MergeBranchName;
+		return ResolveRef(*Merge, CommitId);
+	}
+
+	// Only the default refspec of a remote maps its branches to "refs/remotes/<remote>/<branch>"
+	TMap<FString, FString> RemoteConfig;
+	if (!ReadConfigSection(ConfigFilename, TEXT("remote"), *Remote, RemoteConfig))
+	{
+		return false;
+	}
+	const FString* Fetch = RemoteConfig.Find(TEXT("fetch"));
+	if (!Fetch || (*Fetch != FString::Printf(TEXT("+refs/heads/*:refs/remotes/%s/*"), **Remote)))
+	{
+		return false;
+	}
+	OutUpstreamBranchName = *Remote / MergeBranchName;
+	return ResolveRef(TEXT("refs/remotes/") + OutUpstreamBranchName, CommitId);
+}
+
+void FGitRefsReader::ListRefs(const FString& InPrefix, TMap<FString, FString>& OutRefs) const
+{
+	if (!IsValid())
+	{
+		return;
+	}
+	const TSharedRef<const FPackedRefs, ESPMode::ThreadSafe> PackedRefs = FPackedRefsCache::Get().GetPackedRefs(CommonDirectory / TEXT("packed-refs"));
+	for (const auto& PackedRef : PackedRefs->Refs)
+	{
+		if (PackedRef.Key.StartsWith(InPrefix, ESearchCase::CaseSensitive))
+		{
+			OutRefs.Add(PackedRef.Key, PackedRef.Value);
+		}
+	}
+
+	// Loose references override packed ones
+	const FString CommonDirectoryPrefix = CommonDirectory + TEXT("/");
+	FPlatformFileManager::Get().GetPlatformFile().IterateDirectoryRecursively(*(CommonDirectory / InPrefix), [this, &CommonDirectoryPrefix, &OutRefs](const TCHAR* InFilename, bool bInIsDirectory)
+	{
+		const FString Filename(InFilename);
+		if (!bInIsDirectory && !Filename.EndsWith(TEXT(".lock")) && Filename.StartsWith(CommonDirectoryPrefix))
+		{
+			const FString RefName = Filename.RightChop(CommonDirectoryPrefix.Len());
+			FString Value;
+			if (ReadLooseRef(RefName, Value) && (IsCommitId(Value) || Value.StartsWith(TEXT("ref:"))))
+			{
+				OutRefs.Add(RefName, Value);
+			}
+		}
+		return true;
+	});
+}
+
+FGitRefsWatcher& FGitRefsWatcher::Get()
+{
+	static FGitRefsWatcher Instance;
+	return Instance;
+}
+
+void FGitRefsWatcher::Start(const FString& InRepositoryRoot)
+{
+	Stop();
+
+	const FGitRefsReader Refs(InRepositoryRoot);
+	if (!Refs.IsValid())
+	{
+		return;
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (!DirectoryWatcher)
+	{
+		return;
+	}
+
+	RefsDirectory = Refs.GetCommonDirectory() / TEXT("refs");
+
+	auto Watch = [this, DirectoryWatcher](const FString& InDirectory, const uint32 InFlags)
+	{
+		FDelegateHandle Handle;
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(InDirectory, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FGitRefsWatcher::OnRefsDirectoryChanged), Handle, InFlags))
+		{
+			WatchedDirectories.Emplace(InDirectory, Handle);
+		}
+		else
+		{
+			UE_LOG(LogSourceControl, Warning, TEXT("Failed to watch '%s' for changes of the references"), *InDirectory);
+		}
+	};
+	// HEAD and FETCH_HEAD of the worktree, packed-refs and config of the repository
+	Watch(Refs.GetGitDirectory(), IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree);
+	if (Refs.GetCommonDirectory() != Refs.GetGitDirectory())
+	{
+		Watch(Refs.GetCommonDirectory(), IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree);
+	}
+	// Loose references: local and remote-tracking branches, tags
+	Watch(RefsDirectory, 0);
+
+	// Anything cached before the watch started may be stale
+	Invalidate();
+}
+
+void FGitRefsWatcher::Stop()
+{
+	if (WatchedDirectories.Num() > 0)
+	{
+		if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+		{
+			if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+			{
+				for (const TPair<FString, FDelegateHandle>& WatchedDirectory : WatchedDirectories)
+				{
+					DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory.Key, WatchedDirectory.Value);
+				}
+			}
+		}
+		WatchedDirectories.Empty();
+	}
+	RefsDirectory.Empty();
+	Invalidate();
+}
+
+void FGitRefsWatcher::OnRefsDirectoryChanged(const TArray<FFileChangeData>& InFileChanges)
+{
+	for (const FFileChangeData& FileChange : InFileChanges)
+	{
+		FString Filename = FileChange.Filename;
+		FPaths::NormalizeFilename(Filename);
+		const FString CleanFilename = FPaths::GetCleanFilename(Filename);
+		// Git writes each reference to a "<name>.lock" file, then renames it
+		if (CleanFilename.EndsWith(TEXT(".lock")))
+		{
+			continue;
+		}
+		if ((CleanFilename == TEXT("HEAD")) || (CleanFilename == TEXT("FETCH_HEAD")) || (CleanFilename == TEXT("packed-refs")) || (CleanFilename == TEXT("config"))
+			|| Filename.StartsWith(RefsDirectory + TEXT("/")))
+		{
+			UE_LOG(LogSourceControl, Verbose, TEXT("References changed: '%s'"), *Filename);
+			Invalidate();
+			return;
+		}
+	}
+}
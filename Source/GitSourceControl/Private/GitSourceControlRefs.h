@@ -0,0 +1,125 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/**
+ * In-process reader of the HEAD, the references (loose and packed) and the upstream configuration of a repository,
+ * answering the small queries of the plugin (current branch, upstream branch, remote branches, HEAD commit) without launching Git.
+ *
+ * Handles ".git" files (submodules, worktrees) and the common directory shared by the worktrees of a repository.
+ * Every query returns false when it cannot answer exactly like Git would (unsupported config, missing files...): the caller should then fall back to Git commands.
+ */
+class FGitRefsReader
+{
+public:
+	/** Locate the Git directories of a repository */
+	explicit FGitRefsReader(const FString& InRepositoryRoot);
+
+	/** Tells if the Git directories of the repository were found */
+	bool IsValid() const
+	{
+		return !GitDirectory.IsEmpty();
+	}
+
+	/**
+	 * Read the HEAD of the working tree
+	 * @param	OutSymbolicRef	The full name of the checked-out branch ("refs/heads/main"), empty in detached HEAD
+	 * @param	OutCommitId		The id of the HEAD commit (empty on an unborn branch)
+	 */
+	bool ReadHead(FString& OutSymbolicRef, FString& OutCommitId) const;
+
+	/**
+	 * Resolve a reference ("HEAD", "refs/heads/main", "refs/remotes/origin/main"...) to a commit id, following symbolic references
+	 * @returns false if the reference does not exist
+	 */
+	bool ResolveRef(const FString& InRefName, FString& OutCommitId) const;
+
+	/**
+	 * Get the upstream of a local branch, as "<remote>/<branch>" like "git rev-parse --abbrev-ref @{u}"
+	 * @param	InBranchName	The short name of the local branch ("main")
+	 * @returns false if no upstream is configured, or if its remote-tracking branch does not exist
+	 */
+	bool GetUpstreamBranch(const FString& InBranchName, FString& OutUpstreamBranchName) const;
+
+	/**
+	 * List all references under a prefix, loose and packed
+	 * @param	InPrefix	The prefix of the full reference names ("refs/remotes/")
+	 * @param	OutRefs		Map of the full reference names to their commit id, or to "ref: <target>" for symbolic references
+	 */
+	void ListRefs(const FString& InPrefix, TMap<FString, FString>& OutRefs) const;
+
+	/** Directory of the per-worktree references */
+	const FString& GetGitDirectory() const
+	{
+		return GitDirectory;
+	}
+
+	/** Directory of the references shared by all worktrees */
+	const FString& GetCommonDirectory() const
+	{
+		return CommonDirectory;
+	}
+
+private:
+	/** Read a loose reference: a commit id, or "ref: <target>" */
+	bool ReadLooseRef(const FString& InRefName, FString& OutValue) const;
+
+	/** Find a reference in the packed-refs file */
+	bool ReadPackedRef(const FString& InRefName, FString& OutCommitId) const;
+
+	/** Directory of the per-worktree references (HEAD, refs/worktree/, refs/bisect/...) */
+	FString GitDirectory;
+
+	/** Directory of the references shared by all worktrees (refs/heads/, refs/remotes/, packed-refs, config) */
+	FString CommonDirectory;
+};
+
+/**
+ * Watch the files holding the references of the repository (HEAD, FETCH_HEAD, packed-refs, config and the loose refs/ directory)
+ * and count their changes, so that the values derived from them (current branch, upstream branch, status branches, files changed on remote branches)
+ * can be cached until the next change.
+ *
+ * Only the references are watched: the Git directory itself is not watched recursively, since objects/ and lfs/ can hold tens of thousands of directories.
+ * The commands of the plugin that move references also increment the generation as soon as they return, without waiting for the notifications of the file system.
+ */
+class FGitRefsWatcher
+{
+public:
+	static FGitRefsWatcher& Get();
+
+	/** Start watching the references of a repository (game thread) */
+	void Start(const FString& InRepositoryRoot);
+
+	/** Stop watching (game thread) */
+	void Stop();
+
+	/** Generation of the references: incremented each time they change; a value cached with an older generation is stale */
+	int32 GetGeneration() const
+	{
+		return Generation.GetValue();
+	}
+
+	/** Tell that the references changed (thread-safe) */
+	void Invalidate()
+	{
+		Generation.Increment();
+	}
+
+private:
+	/** Called by the directory watcher on the game thread */
+	void OnRefsDirectoryChanged(const TArray<struct FFileChangeData>& InFileChanges);
+
+	/** Directories being watched, with the handles of their callbacks */
+	TArray<TPair<FString, FDelegateHandle>> WatchedDirectories;
+
+	/** The "refs/" directory of the common directory, watched recursively */
+	FString RefsDirectory;
+
+	FThreadSafeCounter Generation;
+};
@@ -5,6 +5,7 @@
 
 #include "GitSourceControlSettings.h"
 
+#include "HAL/PlatformMisc.h"
 #include "Misc/ConfigCacheIni.h"
 #include "SourceControlHelpers.h"
 
@@ -66,6 +67,26 @@ bool FGitSourceControlSettings::SetLfsUserName(const FString& InString)
 	return bChanged;
 }
 
+bool FGitSourceControlSettings::IsUsingStatusAcceleration() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bUsingStatusAcceleration;
+}
+
+bool FGitSourceControlSettings::SetUsingStatusAcceleration(const bool InUsingStatusAcceleration)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	const bool bChanged = (bUsingStatusAcceleration != InUsingStatusAcceleration);
+	bUsingStatusAcceleration = InUsingStatusAcceleration;
+	return bChanged;
+}
+
+int32 FGitSourceControlSettings::GetMaxParallelBatches() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return (MaxParallelBatches > 0) ? MaxParallelBatches : FPlatformMisc::NumberOfCores();
+}
+
 // This is called at startup nearly before anything else in our module: BinaryPath will then be used by the provider
 void FGitSourceControlSettings::LoadSettings()
 {
@@ -74,6 +95,8 @@ void FGitSourceControlSettings::LoadSettings()
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), BinaryPath, IniFile);
 	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingGitLfsLocking"), bUsingGitLfsLocking, IniFile);
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("LfsUserName"), LfsUserName, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingStatusAcceleration"), bUsingStatusAcceleration, IniFile);
+	GConfig->GetInt(*GitSettingsConstants::SettingsSection, TEXT("MaxParallelBatches"), MaxParallelBatches, IniFile);
 }
 
 void FGitSourceControlSettings::SaveSettings() const
@@ -83,4 +106,6 @@ void FGitSourceControlSettings::SaveSettings() const
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), *BinaryPath, IniFile);
 	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingGitLfsLocking"), bUsingGitLfsLocking, IniFile);
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("LfsUserName"), *LfsUserName, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingStatusAcceleration"), bUsingStatusAcceleration, IniFile);
+	GConfig->SetInt(*GitSettingsConstants::SettingsSection, TEXT("MaxParallelBatches"), MaxParallelBatches, IniFile);
 }
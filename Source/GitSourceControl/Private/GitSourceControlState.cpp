@@ -16,6 +16,70 @@
 
 #define LOCTEXT_NAMESPACE "GitSourceControl.State"
 
+const FGitStateDetails& FGitSourceControlState::GetDetails() const
+{
+	static const FGitStateDetails DefaultDetails;
+	return Details.IsValid() ? *Details : DefaultDetails;
+}
+
+FGitStateDetails& FGitSourceControlState::MutableDetails()
+{
+	if (!Details.IsValid())
+	{
+		Details = MakeShared<FGitStateDetails, ESPMode::ThreadSafe>();
+	}
+	else if (!Details.IsUnique())
+	{
+		Details = MakeShared<FGitStateDetails, ESPMode::ThreadSafe>(*Details);
+	}
+	return *Details;
+}
+
+uint32 FGitSourceControlState::GetCategories() const
+{
+	uint32 Categories = 0;
+	if (IsModified())
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::Modified);
+	}
+	if (IsAdded())
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::Added);
+	}
+	if (IsDeleted())
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::Deleted);
+	}
+	if (State.LockState == ELockState::Locked)
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::LockedByMe);
+	}
+	if (State.LockState == ELockState::LockedOther)
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::LockedByOther);
+	}
+	if (IsConflicted())
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::Conflicted);
+	}
+	if (!IsCurrent())
+	{
+		Categories |= EGitStateCategory::Bit(EGitStateCategory::NotAtHead);
+	}
+	return Categories;
+}
+
+SIZE_T FGitSourceControlState::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = LocalFilename.GetAllocatedSize() + History.GetAllocatedSize() + Changelist.GetName().GetAllocatedSize()
+		+ State.LockUser.GetAllocatedSize() + State.HeadBranch.GetAllocatedSize();
+	if (Details.IsValid())
+	{
+		AllocatedSize += sizeof(FGitStateDetails) + Details->HeadAction.GetAllocatedSize() + Details->HeadCommit.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
 int32 FGitSourceControlState::GetHistorySize() const
 {
 	return History.Num();
@@ -59,7 +123,7 @@ TSharedPtr<class ISourceControlRevision, ESPMode::ThreadSafe> FGitSourceControlS
 	for(const auto& Revision : History)
 	{
 		// look for the the SHA1 id of the file, not the commit id (revision)
-		if (Revision->FileHash == PendingMergeBaseFileHash)
+		if (Revision->FileHash == GetDetails().PendingMergeBaseFileHash)
 		{
 			return Revision;
 		}
@@ -79,7 +143,7 @@ TSharedPtr<class ISourceControlRevision, ESPMode::ThreadSafe> FGitSourceControlS
 #if !UE_VERSION_OLDER_THAN(5, 3, 0)
 ISourceControlState::FResolveInfo FGitSourceControlState::GetResolveInfo() const
 {
-	return PendingResolveInfo;
+	return GetDetails().PendingResolveInfo;
 }
 #endif
 
@@ -198,7 +262,7 @@ FText FGitSourceControlState::GetDisplayTooltip() const
 	case EGitState::LockedOther:
 		return FText::Format(LOCTEXT("CheckedOutOther_Tooltip", "Checked out by: {0}"), FText::FromString(State.LockUser));
 	case EGitState::NotLatest:
-		return FText::Format(LOCTEXT("ModifiedOtherBranch_Tooltip", "Modified in branch: {0} CL:{1} ({2})"), FText::FromString(State.HeadBranch), FText::FromString(HeadCommit), FText::FromString(HeadAction));
+		return FText::Format(LOCTEXT("ModifiedOtherBranch_Tooltip", "Modified in branch: {0} CL:{1} ({2})"), FText::FromString(State.HeadBranch), FText::FromString(GetDetails().HeadCommit), FText::FromString(GetDetails().HeadAction));
 	case EGitState::Unmerged:
 		return LOCTEXT("ContentsConflict_Tooltip", "The contents of the item conflict with updates received from the repository.");
 	case EGitState::Added:
@@ -323,7 +387,7 @@ bool FGitSourceControlState::GetOtherBranchHeadModification(FString& HeadBranchO
 	}
 
 	HeadBranchOut = State.HeadBranch;
-	ActionOut = HeadAction; // TODO: from ERemoteState
+	ActionOut = GetDetails().HeadAction; // TODO: from ERemoteState
 	HeadChangeListOut = 0; // TODO: get head commit
 	return true;
 }
@@ -6,7 +6,12 @@
 #include "GitSourceControlUtils.h"
 
 #include "GitMessageLog.h"
+#include "GitSourceControlCatFile.h"
 #include "GitSourceControlCommand.h"
+#include "GitSourceControlExecutor.h"
+#include "GitSourceControlIndex.h"
+#include "GitSourceControlRefs.h"
+#include "GitSourceControlWorkingTree.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlProvider.h"
 #include "HAL/PlatformProcess.h"
@@ -21,6 +26,7 @@
 #include "ISourceControlModule.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
 #include "GitSourceControlChangelistState.h"
 #include "Logging/MessageLog.h"
 #include "Misc/DateTime.h"
@@ -32,6 +38,7 @@
 #include "UObject/ObjectSaveContext.h"
 
 #include "Async/Async.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "UObject/Linker.h"
 
 
@@ -41,6 +48,9 @@ namespace GitSourceControlConstants
 {
 /** The maximum number of files we submit in a single Git command */
 const int32 MaxFilesPerBatch = 50;
+
+/** The maximum number of commits of the remote branches whose changed files are kept in memory by CheckRemote() */
+const int32 MaxCachedRemoteCommits = 100000;
 } // namespace GitSourceControlConstants
 
 FGitScopedTempFile::FGitScopedTempFile(const FText& InText)
@@ -52,6 +62,23 @@ FGitScopedTempFile::FGitScopedTempFile(const FText& InText)
 	}
 }
 
+FGitScopedTempFile::FGitScopedTempFile(const TArray<FString>& InFiles)
+{
+	Filename = FPaths::CreateTempFilename(*FPaths::ProjectLogDir(), TEXT("Git-Pathspec"), TEXT(".txt"));
+	TArray<uint8> Content;
+	for (const FString& File : InFiles)
+	{
+		const FTCHARToUTF8 FileUtf8(*File);
+		Content.Append(reinterpret_cast<const uint8*>(FileUtf8.Get()), FileUtf8.Length());
+		Content.Add('\0');
+	}
+	if (!FFileHelper::SaveArrayToFile(Content, *Filename))
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to write to temp file: %s"), *Filename);
+		Filename.Empty();
+	}
+}
+
 FGitScopedTempFile::~FGitScopedTempFile()
 {
 	if (FPaths::FileExists(Filename))
@@ -175,12 +202,41 @@ namespace GitSourceControlUtils
 		return ChangeRepositoryRootIfSubmodule(AbsoluteFilePaths, PathToRepositoryRoot);
 	}
 
-// Launch the Git command line process and extract its results & errors
-bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const int32 ExpectedReturnCode /* = 0 */)
+// Get the executable to launch for a Git command line, wrapping it if needed
+FString GetGitLaunchExecutable(const FString& InPathToGitBinary, FString& InOutFullCommand)
+{
+	FString PathToGitOrEnvBinary = InPathToGitBinary;
+#if PLATFORM_MAC
+	// The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
+	FString PathEnv = FPlatformMisc::GetEnvironmentVariable(TEXT("PATH"));
+	FString GitInstallPath = FPaths::GetPath(InPathToGitBinary);
+
+	TArray<FString> PathArray;
+	PathEnv.ParseIntoArray(PathArray, FPlatformMisc::GetPathVarDelimiter());
+	bool bHasGitInstallPath = false;
+	for (auto Path : PathArray)
+	{
+		if (GitInstallPath.Equals(Path, ESearchCase::CaseSensitive))
+		{
+			bHasGitInstallPath = true;
+			break;
+		}
+	}
+
+	if (!bHasGitInstallPath)
+	{
+		PathToGitOrEnvBinary = FString("/usr/bin/env");
+		InOutFullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *GitInstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToGitBinary, *InOutFullCommand);
+	}
+#endif
+	return PathToGitOrEnvBinary;
+}
+
+// Build the full command line of a Git command, and its short version for logging purpose
+static FString BuildGitCommandLine(const FString& InCommand, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutLogableCommand)
 {
-	int32 ReturnCode = 0;
 	FString FullCommand;
-	FString LogableCommand; // short version of the command for logging purpose
+	FString& LogableCommand = OutLogableCommand;
 
 	if (!InRepositoryRoot.IsEmpty())
 	{
@@ -202,6 +258,11 @@ bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitB
 		FullCommand += RepositoryRoot;
 		FullCommand += TEXT("\" ");
 	}
+	// then the global options accelerating "git status", given to all commands so that the ones writing the index also keep the fsmonitor and untracked cache extensions
+	if (const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe())
+	{
+		FullCommand += GitSourceControl->GetProvider().GetStatusAccelerationOptions();
+	}
 	// then the git command itself ("status", "log", "commit"...)
 	LogableCommand += InCommand;
 
@@ -221,35 +282,40 @@ bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitB
 
 	FullCommand += LogableCommand;
 
-	UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand: 'git %s'"), *LogableCommand);
-
-	FString PathToGitOrEnvBinary = InPathToGitBinary;
-#if PLATFORM_MAC
-	// The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
-	FString PathEnv = FPlatformMisc::GetEnvironmentVariable(TEXT("PATH"));
-	FString GitInstallPath = FPaths::GetPath(InPathToGitBinary);
+	return FullCommand;
+}
 
-	TArray<FString> PathArray;
-	PathEnv.ParseIntoArray(PathArray, FPlatformMisc::GetPathVarDelimiter());
-	bool bHasGitInstallPath = false;
-	for (auto Path : PathArray)
+// Tell if a Git command can move the references of the repository (HEAD, local or remote-tracking branches)
+static bool CanChangeRefs(const FString& InCommand, const TArray<FString>& InFiles)
+{
+	if (InCommand.Equals(TEXT("fetch")) || InCommand.Equals(TEXT("pull")) || InCommand.Equals(TEXT("push")) || InCommand.Equals(TEXT("commit"))
+		|| InCommand.Equals(TEXT("merge")) || InCommand.Equals(TEXT("rebase")) || InCommand.Equals(TEXT("switch")) || InCommand.Equals(TEXT("branch")))
 	{
-		if (GitInstallPath.Equals(Path, ESearchCase::CaseSensitive))
-		{
-			bHasGitInstallPath = true;
-			break;
-		}
+		return true;
 	}
+	// "reset" and "checkout" only move HEAD when not given any file
+	return (InFiles.Num() == 0) && (InCommand.Equals(TEXT("reset")) || InCommand.Equals(TEXT("checkout")));
+}
 
-	if (!bHasGitInstallPath)
-	{
-		PathToGitOrEnvBinary = FString("/usr/bin/env");
-		FullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *GitInstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToGitBinary, *FullCommand);
-	}
-#endif
+// Launch the Git command line process and extract its results & errors
+bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const int32 ExpectedReturnCode /* = 0 */)
+{
+	int32 ReturnCode = 0;
+	FString LogableCommand; // short version of the command for logging purpose
+	FString FullCommand = BuildGitCommandLine(InCommand, InRepositoryRoot, InParameters, InFiles, LogableCommand);
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand: 'git %s'"), *LogableCommand);
+
+	const FString PathToGitOrEnvBinary = GetGitLaunchExecutable(InPathToGitBinary, FullCommand);
 
 	FPlatformProcess::ExecProcess(*PathToGitOrEnvBinary, *FullCommand, &ReturnCode, &OutResults, &OutErrors);
 
+	// Don't wait for the notifications of the file system to invalidate the values derived from the references
+	if (CanChangeRefs(InCommand, InFiles))
+	{
+		FGitRefsWatcher::Get().Invalidate();
+	}
+
 	UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand(%s):\n%s"), *InCommand, *OutResults);
 	if (ReturnCode != ExpectedReturnCode)
 	{
@@ -281,6 +347,162 @@ static bool RunCommandInternal(const FString& InCommand, const FString& InPathTo
 	return bResult;
 }
 
+/**
+ * Split the output of a Git command into records (lines, or NUL-terminated records) as it is read from its pipe.
+ *
+ * Only the incomplete last record of each chunk of data is kept (and copied) between two reads.
+ */
+class FGitRecordReader
+{
+public:
+	FGitRecordReader(const ANSICHAR InDelimiter, const TFunctionRef<void(FStringView)>& InOnRecord)
+		: Delimiter(InDelimiter)
+		, OnRecord(InOnRecord)
+	{
+	}
+
+	/** Hand all complete records of the data to the callback, keeping the remaining for the next call */
+	void Consume(const TArray<uint8>& InData)
+	{
+		int32 Start = 0;
+		for (int32 Index = 0; Index < InData.Num(); ++Index)
+		{
+			if (InData[Index] == Delimiter)
+			{
+				if (Pending.Num() > 0)
+				{
+					Pending.Append(InData.GetData() + Start, Index - Start);
+					Emit(Pending.GetData(), Pending.Num());
+					Pending.Reset();
+				}
+				else
+				{
+					Emit(InData.GetData() + Start, Index - Start);
+				}
+				Start = Index + 1;
+			}
+		}
+		Pending.Append(InData.GetData() + Start, InData.Num() - Start);
+	}
+
+	/** Hand the last record (if not terminated) to the callback */
+	void Flush()
+	{
+		Emit(Pending.GetData(), Pending.Num());
+		Pending.Reset();
+	}
+
+private:
+	void Emit(const uint8* InData, const int32 InLen)
+	{
+		// Skip empty records, like ParseIntoArray() does for the non-streaming commands
+		if (InLen > 0)
+		{
+			const FUTF8ToTCHAR Record(reinterpret_cast<const ANSICHAR*>(InData), InLen);
+			OnRecord(FStringView(Record.Get(), Record.Length()));
+		}
+	}
+
+	const ANSICHAR Delimiter;
+	const TFunctionRef<void(FStringView)>& OnRecord;
+	TArray<uint8> Pending;
+};
+
+// Launch the Git command line process and hand each record of its output to a callback while it is running
+static bool RunCommandStreamingInternal(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters,
+										const TArray<FString>& InFiles, const TFunctionRef<void(FStringView)>& InOnRecord, TArray<FString>& OutErrorMessages, const ANSICHAR InDelimiter)
+{
+	int32 ReturnCode = -1;
+	FString LogableCommand; // short version of the command for logging purpose
+	FString FullCommand = BuildGitCommandLine(InCommand, InRepositoryRoot, InParameters, InFiles, LogableCommand);
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand: 'git %s'"), *LogableCommand);
+
+	const FString PathToGitOrEnvBinary = GetGitLaunchExecutable(InPathToGitBinary, FullCommand);
+
+	FString Errors;
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	// CreateProc() has no separate pipe for stderr before UE5: run the command to completion, then split its output into records
+	FString Results;
+	if (FPlatformProcess::ExecProcess(*PathToGitOrEnvBinary, *FullCommand, &ReturnCode, &Results, &Errors))
+	{
+		FGitRecordReader Reader(InDelimiter, InOnRecord);
+		const FTCHARToUTF8 ResultsUtf8(*Results, Results.Len());
+		const TArray<uint8> Data(reinterpret_cast<const uint8*>(ResultsUtf8.Get()), ResultsUtf8.Length());
+		Reader.Consume(Data);
+		Reader.Flush();
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to launch 'git %s'"), *InCommand);
+	}
+#else
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	verify(FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite));
+	verify(FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite));
+
+	const bool bLaunchDetached = false;
+	const bool bLaunchHidden = true;
+	const bool bLaunchReallyHidden = bLaunchHidden;
+	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*PathToGitOrEnvBinary, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, nullptr, StdOutWrite, nullptr, StdErrWrite);
+	if (ProcessHandle.IsValid())
+	{
+		FGitRecordReader Reader(InDelimiter, InOnRecord);
+		TArray<uint8> Data;
+		for (;;)
+		{
+			// Check if the process is still running before reading, so that nothing written before it exited is missed
+			const bool bRunning = FPlatformProcess::IsProcRunning(ProcessHandle);
+			bool bReadData = false;
+			while (FPlatformProcess::ReadPipeToArray(StdOutRead, Data) && (Data.Num() > 0))
+			{
+				Reader.Consume(Data);
+				bReadData = true;
+			}
+			for (FString ErrorData = FPlatformProcess::ReadPipe(StdErrRead); !ErrorData.IsEmpty(); ErrorData = FPlatformProcess::ReadPipe(StdErrRead))
+			{
+				Errors += ErrorData;
+				bReadData = true;
+			}
+			if (!bRunning)
+			{
+				break;
+			}
+			if (!bReadData)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+		Reader.Flush();
+
+		FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to launch 'git %s'"), *InCommand);
+	}
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+#endif
+
+	if (ReturnCode != 0)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("RunCommand(%s) ReturnCode=%d:\n%s"), *InCommand, ReturnCode, *Errors);
+		Errors.ParseIntoArray(OutErrorMessages, TEXT("\n"), true);
+	}
+	else if (Errors.Len() > 0)
+	{
+		// Warnings and progress information are not part of the records of the output
+		UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand(%s):\n%s"), *InCommand, *Errors);
+	}
+
+	return ReturnCode == 0;
+}
+
 FString FindGitBinaryPath()
 {
 #if PLATFORM_WINDOWS
@@ -547,6 +769,146 @@ void ParseGitVersion(const FString& InVersionString, FGitVersion* OutVersion)
 	}
 }
 
+void FindGitCapabilities(const FString& InPathToGitBinary, FGitVersion* OutVersion)
+{
+	// "git rm" was the last command to learn "--pathspec-from-file", in Git 2.26
+	OutVersion->bHasPathspecFromFile = OutVersion->IsGreaterOrEqualThan(2, 26);
+	if (OutVersion->bHasPathspecFromFile)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Git supports --pathspec-from-file: files are not batched on the command line"));
+	}
+	OutVersion->bHasStatusPorcelainV2 = OutVersion->IsGreaterOrEqualThan(2, 11);
+	OutVersion->bHasUntrackedCache = OutVersion->IsGreaterOrEqualThan(2, 8);
+	// The builtin daemon is not available on Linux: a hook can query Watchman instead (see FindStatusAcceleration())
+#if PLATFORM_WINDOWS || PLATFORM_MAC
+	OutVersion->bHasFsMonitorDaemon = OutVersion->IsGreaterOrEqualThan(2, 36);
+#endif
+}
+
+// Tells if Watchman is installed, looking for it in the PATH
+static bool IsWatchmanAvailable()
+{
+#if PLATFORM_LINUX || PLATFORM_MAC
+	int32 ReturnCode = -1;
+	FString Results;
+	FString Errors;
+	return FPlatformProcess::ExecProcess(TEXT("/usr/bin/env"), TEXT("watchman --version"), &ReturnCode, &Results, &Errors) && (ReturnCode == 0);
+#else
+	return false;
+#endif
+}
+
+// Install the "fsmonitor-watchman" hook from the sample that Git copies in the hooks directory of each new repository
+static bool InstallWatchmanHook(const FString& InWatchmanHook)
+{
+	const FString WatchmanHookSample = InWatchmanHook + TEXT(".sample");
+	if (!FPaths::FileExists(WatchmanHookSample) || (IFileManager::Get().Copy(*InWatchmanHook, *WatchmanHookSample) != COPY_OK))
+	{
+		return false;
+	}
+#if PLATFORM_LINUX || PLATFORM_MAC
+	// Copying the file does not keep its executable permission
+	int32 ReturnCode = -1;
+	FPlatformProcess::ExecProcess(TEXT("/bin/chmod"), *FString::Printf(TEXT("+x \"%s\""), *InWatchmanHook), &ReturnCode, nullptr, nullptr);
+	if (ReturnCode != 0)
+	{
+		IFileManager::Get().Delete(*InWatchmanHook);
+		return false;
+	}
+#endif
+	UE_LOG(LogSourceControl, Log, TEXT("Installed the fsmonitor-watchman hook: %s"), *InWatchmanHook);
+	return true;
+}
+
+void FindStatusAcceleration(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FGitVersion& InVersion, const bool bInInstallHook, FString& OutOptions, FString& OutDescription)
+{
+	OutOptions.Empty();
+	TArray<FString> Features;
+
+	// List the whole configuration once: "config --get" exits with code 1 for a key that is not set, which is the usual case here
+	TArray<FString> ConfigEntries;
+	{
+		TArray<FString> ErrorMessages;
+		RunCommand(TEXT("config"), InPathToGitBinary, InRepositoryRoot, {TEXT("--list")}, FGitSourceControlModule::GetEmptyStringArray(), ConfigEntries, ErrorMessages);
+	}
+	auto ReadConfig = [&ConfigEntries](const TCHAR* InName, FString& OutValue)
+	{
+		// Entries are listed as "section.key=value" (lowercase names), the last one taking precedence; a key without value means "true"
+		bool bFound = false;
+		for (const FString& Entry : ConfigEntries)
+		{
+			FString Name = Entry;
+			FString Value = TEXT("true");
+			Entry.Split(TEXT("="), &Name, &Value);
+			if (Name.Equals(InName, ESearchCase::IgnoreCase))
+			{
+				OutValue = MoveTemp(Value);
+				bFound = true;
+			}
+		}
+		return bFound;
+	};
+
+	// Never override the choices made in the configuration of the repository
+	FString FsMonitor;
+	if (ReadConfig(TEXT("core.fsmonitor"), FsMonitor))
+	{
+		Features.Add(FString::Printf(TEXT("core.fsmonitor=%s (configured)"), *FsMonitor));
+	}
+	else if (InVersion.bHasFsMonitorDaemon)
+	{
+		OutOptions += TEXT("-c core.fsmonitor=true ");
+		Features.Add(TEXT("builtin fsmonitor daemon"));
+	}
+	else
+	{
+		// Hook querying Watchman, installed from the "fsmonitor-watchman.sample" shipped with Git (the fast path on Linux)
+		const FGitRefsReader Refs(InRepositoryRoot);
+		const FString WatchmanHook = Refs.GetCommonDirectory() / TEXT("hooks/fsmonitor-watchman");
+		const bool bHasWatchmanHook = Refs.IsValid() && FPaths::FileExists(WatchmanHook);
+		const bool bHasWatchman = !bHasWatchmanHook && IsWatchmanAvailable();
+		if (bHasWatchmanHook || (Refs.IsValid() && bInInstallHook && bHasWatchman && InstallWatchmanHook(WatchmanHook)))
+		{
+			OutOptions += FString::Printf(TEXT("-c \"core.fsmonitor=%s\" "), *WatchmanHook);
+			Features.Add(TEXT("fsmonitor-watchman hook"));
+		}
+		// Tell in the settings why there is no file system monitor, and how to get one
+#if PLATFORM_LINUX || PLATFORM_MAC
+		else if (!bHasWatchman)
+		{
+			Features.Add(TEXT("no fsmonitor (install Watchman to use the fsmonitor-watchman hook)"));
+		}
+		else if (!bInInstallHook)
+		{
+			Features.Add(TEXT("no fsmonitor (check 'Accelerate status' to install the fsmonitor-watchman hook)"));
+		}
+		else
+		{
+			Features.Add(FString::Printf(TEXT("no fsmonitor (unable to install %s from its .sample)"), *WatchmanHook));
+		}
+#else
+		else
+		{
+			Features.Add(TEXT("no fsmonitor (the builtin daemon needs Git 2.36)"));
+		}
+#endif
+	}
+
+	FString UntrackedCache;
+	if (ReadConfig(TEXT("core.untrackedCache"), UntrackedCache))
+	{
+		Features.Add(FString::Printf(TEXT("core.untrackedCache=%s (configured)"), *UntrackedCache));
+	}
+	else if (InVersion.bHasUntrackedCache)
+	{
+		OutOptions += TEXT("-c core.untrackedCache=true ");
+		Features.Add(TEXT("untracked cache"));
+	}
+
+	OutDescription = FString::Join(Features, TEXT(", "));
+	UE_LOG(LogSourceControl, Log, TEXT("Status acceleration: %s"), OutDescription.IsEmpty() ? TEXT("none") : *OutDescription);
+}
+
 // Find the root of the Git repository, looking from the provided path and upward in its parent directories.
 bool FindRootDirectory(const FString& InPath, FString& OutRepositoryRoot)
 {
@@ -591,6 +953,34 @@ bool FindRootDirectory(const FString& InPath, FString& OutRepositoryRoot)
 	return bFound;
 }
 
+bool FindGitDirectory(const FString& InRepositoryRoot, FString& OutGitDirectory)
+{
+	const FString PathToGitSubdirectory = InRepositoryRoot / TEXT(".git");
+	if (IFileManager::Get().DirectoryExists(*PathToGitSubdirectory))
+	{
+		OutGitDirectory = PathToGitSubdirectory;
+		return true;
+	}
+
+	// A ".git" file points to the actual Git directory: "gitdir: ../.git/worktrees/Name" (absolute or relative to the working tree)
+	FString GitFileContent;
+	if (FFileHelper::LoadFileToString(GitFileContent, *PathToGitSubdirectory) && GitFileContent.StartsWith(TEXT("gitdir:")))
+	{
+		FString GitDirectory = GitFileContent.RightChop(7).TrimStartAndEnd();
+		if (FPaths::IsRelative(GitDirectory))
+		{
+			GitDirectory = FPaths::ConvertRelativePathToFull(InRepositoryRoot, GitDirectory);
+		}
+		if (IFileManager::Get().DirectoryExists(*GitDirectory))
+		{
+			OutGitDirectory = MoveTemp(GitDirectory);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void GetUserConfig(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail)
 {
 	bool bResults;
@@ -629,11 +1019,20 @@ bool GetBranchName(const FString& InPathToGitBinary, const FString& InRepository
 	{
 		return false;
 	}
-	const FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
-	if (!Provider.GetBranchName().IsEmpty())
+	OutBranchName = GitSourceControl->GetProvider().GetBranchName();
+	return !OutBranchName.IsEmpty();
+}
+
+bool ReadBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	// Read the HEAD without launching Git (but let Git describe a detached HEAD)
 	{
-		OutBranchName = Provider.GetBranchName();
-		return true;
+		FString HeadRef, HeadCommitId;
+		if (FGitRefsReader(InRepositoryRoot).ReadHead(HeadRef, HeadCommitId) && HeadRef.StartsWith(TEXT("refs/heads/")))
+		{
+			OutBranchName = HeadRef.RightChop(11);
+			return true;
+		}
 	}
 	
 	bool bResults;
@@ -675,11 +1074,20 @@ bool GetRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepo
 	{
 		return false;
 	}
-	const FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
-	if (!Provider.GetRemoteBranchName().IsEmpty())
+	OutBranchName = GitSourceControl->GetProvider().GetRemoteBranchName();
+	return !OutBranchName.IsEmpty();
+}
+
+bool ReadRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	// Read the upstream of the current branch from the config, without launching Git
 	{
-		OutBranchName = Provider.GetRemoteBranchName();
-		return true;
+		const FGitRefsReader Refs(InRepositoryRoot);
+		FString HeadRef, HeadCommitId;
+		if (Refs.ReadHead(HeadRef, HeadCommitId) && HeadRef.StartsWith(TEXT("refs/heads/")) && Refs.GetUpstreamBranch(HeadRef.RightChop(11), OutBranchName))
+		{
+			return true;
+		}
 	}
 
 	TArray<FString> InfoMessages;
@@ -708,10 +1116,41 @@ bool GetRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepo
 
 bool GetRemoteBranchesWildcard(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& PatternMatch, TArray<FString>& OutBranchNames)
 {
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--remotes"));
+	// List the remote-tracking branches without launching Git (character classes of patterns are left to Git)
+	const FGitRefsReader Refs(InRepositoryRoot);
+	if (Refs.IsValid() && !PatternMatch.Contains(TEXT("[")))
+	{
+		TMap<FString, FString> RemoteRefs;
+		Refs.ListRefs(TEXT("refs/remotes/"), RemoteRefs);
+		RemoteRefs.KeySort([](const FString& A, const FString& B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; });
+		TArray<FString> BranchNames;
+		for (const auto& RemoteRef : RemoteRefs)
+		{
+			const FString BranchName = RemoteRef.Key.RightChop(13);
+			if (BranchName.MatchesWildcard(PatternMatch, ESearchCase::CaseSensitive))
+			{
+				// Same output as "git branch --remotes --list", ie. "origin/HEAD -> origin/main"
+				if (RemoteRef.Value.StartsWith(TEXT("ref: refs/remotes/")))
+				{
+					BranchNames.Add(FString::Printf(TEXT("%s -> %s"), *BranchName, *RemoteRef.Value.RightChop(18)));
+				}
+				else
+				{
+					BranchNames.Add(BranchName);
+				}
+			}
+		}
+		if (BranchNames.Num() > 0)
+		{
+			OutBranchNames = MoveTemp(BranchNames);
+		}
+		return true;
+	}
+
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("--remotes"));
 	Parameters.Add(TEXT("--list"));
 	bool bResults = RunCommand(TEXT("branch"), InPathToGitBinary, InRepositoryRoot, Parameters, { PatternMatch },
 								InfoMessages, ErrorMessages);
@@ -733,6 +1172,41 @@ bool GetRemoteBranchesWildcard(const FString& InPathToGitBinary, const FString&
 	
 bool GetCommitInfo(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary)
 {
+	// Resolve the HEAD without launching Git, and read its commit from the persistent "cat-file --batch" process
+	{
+		FString HeadRef, HeadCommitId;
+		TArray<uint8> CommitContent;
+		if (FGitRefsReader(InRepositoryRoot).ReadHead(HeadRef, HeadCommitId) && !HeadCommitId.IsEmpty()
+			&& FGitCatFilePool::Get().ReadObject(InPathToGitBinary, InRepositoryRoot, HeadCommitId, CommitContent))
+		{
+			// Headers, an empty line, and the message: its first paragraph is the subject (%s), with its lines joined by spaces
+			const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(CommitContent.GetData()), CommitContent.Num());
+			const FString Commit(Converted.Length(), Converted.Get());
+			const int32 MessageIndex = Commit.Find(TEXT("\n\n"), ESearchCase::CaseSensitive);
+			if (MessageIndex != INDEX_NONE)
+			{
+				TArray<FString> MessageLines;
+				Commit.RightChop(MessageIndex + 2).ParseIntoArray(MessageLines, TEXT("\n"), false);
+				TArray<FString> SubjectLines;
+				for (const FString& Line : MessageLines)
+				{
+					if (Line.TrimStartAndEnd().IsEmpty())
+					{
+						if (SubjectLines.Num() > 0)
+						{
+							break;
+						}
+						continue;
+					}
+					SubjectLines.Add(Line.TrimStartAndEnd());
+				}
+				OutCommitId = MoveTemp(HeadCommitId);
+				OutCommitSummary = FString::Join(SubjectLines, TEXT(" "));
+				return true;
+			}
+		}
+	}
+
 	bool bResults;
 	TArray<FString> InfoMessages;
 	TArray<FString> ErrorMessages;
@@ -765,33 +1239,224 @@ bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryR
 	return bResults;
 }
 
+// Tells if the list of files of a command can be given through a "--pathspec-from-file" instead of batches on the command line
+static bool CanUsePathspecFromFile(const FString& InCommand, const FString& InRepositoryRoot, const TArray<FString>& InFiles)
+{
+	if (InFiles.Num() <= GitSourceControlConstants::MaxFilesPerBatch)
+	{
+		return false; // a single batch: nothing to gain
+	}
+	if (!InCommand.Equals(TEXT("add")) && !InCommand.Equals(TEXT("commit")) && !InCommand.Equals(TEXT("reset")) && !InCommand.Equals(TEXT("restore"))
+		&& !InCommand.Equals(TEXT("checkout")) && !InCommand.Equals(TEXT("rm")))
+	{
+		return false;
+	}
+	// The "migrate asset" scenario runs the command from the repository of the files (see BuildGitCommandLine())
+	if (!FPaths::IsRelative(InFiles[0]) && !InFiles[0].StartsWith(InRepositoryRoot))
+	{
+		return false;
+	}
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	return GitSourceControl && GitSourceControl->GetProvider().GetGitVersion().bHasPathspecFromFile;
+}
+
+// Add the "--pathspec-from-file" options before the end of the options (if any, else at the end)
+static TArray<FString> AppendPathspecFromFile(const TArray<FString>& InParameters, const FGitScopedTempFile& InPathspecFile)
+{
+	TArray<FString> Parameters = InParameters;
+	int32 EndOfOptionsIndex = Parameters.Find(TEXT("--"));
+	if (EndOfOptionsIndex == INDEX_NONE)
+	{
+		EndOfOptionsIndex = Parameters.Num();
+	}
+	Parameters.Insert(FString::Printf(TEXT("--pathspec-from-file=\"%s\""), *FPaths::ConvertRelativePathToFull(InPathspecFile.GetFilename())), EndOfOptionsIndex);
+	Parameters.Insert(TEXT("--pathspec-file-nul"), EndOfOptionsIndex + 1);
+	return Parameters;
+}
+
+// Tells if a command only reads the repository, so that its batches can run concurrently (index-mutating commands must stay serialized)
+static bool IsReadOnlyCommand(const FString& InCommand)
+{
+	// Skip the global options in front of the command itself (ie. "--no-optional-locks status")
+	TArray<FString> Tokens;
+	InCommand.ParseIntoArrayWS(Tokens);
+	bool bNoOptionalLocks = false;
+	for (const FString& Token : Tokens)
+	{
+		if (Token.StartsWith(TEXT("-")))
+		{
+			bNoOptionalLocks |= Token.Equals(TEXT("--no-optional-locks"));
+			continue;
+		}
+		// "status" refreshes the index when it can lock it, unless told otherwise
+		if (Token.Equals(TEXT("status")))
+		{
+			return bNoOptionalLocks;
+		}
+		return Token.Equals(TEXT("ls-files")) || Token.Equals(TEXT("check-attr")) || Token.Equals(TEXT("log")) || Token.Equals(TEXT("show"))
+			|| Token.Equals(TEXT("diff")) || Token.Equals(TEXT("cat-file")) || Token.Equals(TEXT("ls-tree"));
+	}
+	return false;
+}
+
+// Number of Git processes to run concurrently for the batches of a command
+static int32 GetNumParallelBatches(const FString& InCommand, const int32 InNumBatches)
+{
+	if ((InNumBatches <= 1) || !IsReadOnlyCommand(InCommand))
+	{
+		return 1;
+	}
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	const int32 MaxParallelBatches = GitSourceControl ? GitSourceControl->AccessSettings().GetMaxParallelBatches() : 1;
+	return FMath::Clamp(MaxParallelBatches, 1, InNumBatches);
+}
+
+/**
+ * Run a function on each batch of files, by up to InNumParallelBatches concurrent tasks
+ * @param	InRunBatch	Run the command on a batch of files; when concurrent, it must only write to the results of its own batch index
+ * @returns true if all batches succeeded
+ */
+static bool RunBatches(const FString& InCommand, const TArray<FString>& InFiles, const int32 InNumParallelBatches, const TFunctionRef<bool(const int32 InBatchIndex, const TArray<FString>& InFilesInBatch)>& InRunBatch)
+{
+	const int32 NumBatches = FMath::DivideAndRoundUp(InFiles.Num(), GitSourceControlConstants::MaxFilesPerBatch);
+	// Background commands (fetch, status of the whole working copy...) let the more urgent ones run between their batches
+	const EGitCommandPriority::Type Priority = FGitSourceControlExecutor::GetCurrentPriority();
+	auto RunBatch = [&InFiles, &InRunBatch, Priority](const int32 InBatchIndex)
+	{
+		if (Priority == EGitCommandPriority::Background && InBatchIndex > 0)
+		{
+			FGitSourceControlExecutor::Get().YieldToHigherPriority(Priority);
+		}
+		const int32 FirstFile = InBatchIndex * GitSourceControlConstants::MaxFilesPerBatch;
+		const int32 NumFilesInBatch = FMath::Min(GitSourceControlConstants::MaxFilesPerBatch, InFiles.Num() - FirstFile);
+		const TArray<FString> FilesInBatch(InFiles.GetData() + FirstFile, NumFilesInBatch);
+		return InRunBatch(InBatchIndex, FilesInBatch);
+	};
+
+	bool bResult = true;
+	if (InNumParallelBatches <= 1)
+	{
+		for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+		{
+			bResult &= RunBatch(BatchIndex);
+		}
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand(%s): %d batches by %d processes"), *InCommand, NumBatches, InNumParallelBatches);
+
+		// Each task pulls the next batch to run, so that a slow batch does not hold up the others.
+		// The tasks run on the batch threads of the executor, never on the task graph workers that Git processes would keep waiting.
+		FThreadSafeCounter NextBatchIndex;
+		FThreadSafeCounter NumFailedBatches;
+		FGitSourceControlExecutor::Get().RunParallelTasks(InNumParallelBatches, [&]()
+		{
+			for (int32 BatchIndex = NextBatchIndex.Increment() - 1; BatchIndex < NumBatches; BatchIndex = NextBatchIndex.Increment() - 1)
+			{
+				if (!RunBatch(BatchIndex))
+				{
+					NumFailedBatches.Increment();
+				}
+			}
+		});
+		bResult = (NumFailedBatches.GetValue() == 0);
+	}
+	return bResult;
+}
+
 bool RunCommand(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters,
 				const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
 {
 	bool bResult = true;
 
+	if (CanUsePathspecFromFile(InCommand, InRepositoryRoot, InFiles))
+	{
+		// Give all the files at once to a single Git process
+		const FGitScopedTempFile PathspecFile(InFiles);
+		if (!PathspecFile.GetFilename().IsEmpty())
+		{
+			return RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, AppendPathspecFromFile(InParameters, PathspecFile), FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+		}
+	}
+
 	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
 	{
-		// Batch files up so we dont exceed command-line limits
-		int32 FileCount = 0;
-		while (FileCount < InFiles.Num())
+		// Batch files up so we dont exceed command-line limits, each batch having its own results to merge them in order
+		const int32 NumBatches = FMath::DivideAndRoundUp(InFiles.Num(), GitSourceControlConstants::MaxFilesPerBatch);
+		TArray<TArray<FString>> BatchResults;
+		TArray<TArray<FString>> BatchErrors;
+		BatchResults.SetNum(NumBatches);
+		BatchErrors.SetNum(NumBatches);
+		bResult = RunBatches(InCommand, InFiles, GetNumParallelBatches(InCommand, NumBatches), [&](const int32 InBatchIndex, const TArray<FString>& InFilesInBatch)
 		{
-			TArray<FString> FilesInBatch;
-			for (int32 FileIndex = 0; FileCount < InFiles.Num() && FileIndex < GitSourceControlConstants::MaxFilesPerBatch; FileIndex++, FileCount++)
+			return RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFilesInBatch, BatchResults[InBatchIndex], BatchErrors[InBatchIndex]);
+		});
+		for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+		{
+			OutResults += MoveTemp(BatchResults[BatchIndex]);
+			OutErrorMessages += MoveTemp(BatchErrors[BatchIndex]);
+		}
+	}
+	else
+	{
+		bResult = RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFiles, OutResults, OutErrorMessages);
+	}
+
+	return bResult;
+}
+
+bool RunCommandStreaming(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters,
+						 const TArray<FString>& InFiles, const TFunctionRef<void(FStringView)>& InOnRecord, TArray<FString>& OutErrorMessages, const ANSICHAR InDelimiter /* = '\n' */)
+{
+	bool bResult = true;
+
+	if (CanUsePathspecFromFile(InCommand, InRepositoryRoot, InFiles))
+	{
+		// Give all the files at once to a single Git process
+		const FGitScopedTempFile PathspecFile(InFiles);
+		if (!PathspecFile.GetFilename().IsEmpty())
+		{
+			return RunCommandStreamingInternal(InCommand, InPathToGitBinary, InRepositoryRoot, AppendPathspecFromFile(InParameters, PathspecFile), FGitSourceControlModule::GetEmptyStringArray(), InOnRecord, OutErrorMessages, InDelimiter);
+		}
+	}
+
+	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
+	{
+		// Batch files up so we dont exceed command-line limits
+		const int32 NumBatches = FMath::DivideAndRoundUp(InFiles.Num(), GitSourceControlConstants::MaxFilesPerBatch);
+		const int32 NumParallelBatches = GetNumParallelBatches(InCommand, NumBatches);
+		if (NumParallelBatches > 1)
+		{
+			// Concurrent batches buffer their records, replayed in order so that the callback is never called concurrently
+			TArray<TArray<FString>> BatchRecords;
+			TArray<TArray<FString>> BatchErrors;
+			BatchRecords.SetNum(NumBatches);
+			BatchErrors.SetNum(NumBatches);
+			bResult = RunBatches(InCommand, InFiles, NumParallelBatches, [&](const int32 InBatchIndex, const TArray<FString>& InFilesInBatch)
 			{
-				FilesInBatch.Add(InFiles[FileCount]);
+				TArray<FString>& Records = BatchRecords[InBatchIndex];
+				return RunCommandStreamingInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFilesInBatch, [&Records](FStringView InRecord) { Records.Emplace(InRecord); }, BatchErrors[InBatchIndex], InDelimiter);
+			});
+			for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+			{
+				for (const FString& Record : BatchRecords[BatchIndex])
+				{
+					InOnRecord(Record);
+				}
+				OutErrorMessages += MoveTemp(BatchErrors[BatchIndex]);
 			}
-
-			TArray<FString> BatchResults;
-			TArray<FString> BatchErrors;
-			bResult &= RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, FilesInBatch, BatchResults, BatchErrors);
-			OutResults += BatchResults;
-			OutErrorMessages += BatchErrors;
+		}
+		else
+		{
+			bResult = RunBatches(InCommand, InFiles, 1, [&](const int32 InBatchIndex, const TArray<FString>& InFilesInBatch)
+			{
+				return RunCommandStreamingInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFilesInBatch, InOnRecord, OutErrorMessages, InDelimiter);
+			});
 		}
 	}
 	else
 	{
-		bResult = RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFiles, OutResults, OutErrorMessages);
+		bResult = RunCommandStreamingInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFiles, InOnRecord, OutErrorMessages, InDelimiter);
 	}
 
 	return bResult;
@@ -842,6 +1507,18 @@ bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot
 
 	TArray<FString> AddParameters{TEXT("-A")};
 
+	if (CanUsePathspecFromFile(TEXT("commit"), InRepositoryRoot, InFiles))
+	{
+		// A single "add" and a single "commit" for all the files, instead of amending the commit for each batch
+		const FGitScopedTempFile PathspecFile(InFiles);
+		if (!PathspecFile.GetFilename().IsEmpty())
+		{
+			bResult &= RunCommandInternal(TEXT("add"), InPathToGitBinary, InRepositoryRoot, AppendPathspecFromFile(AddParameters, PathspecFile), FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+			bResult &= RunCommandInternal(TEXT("commit"), InPathToGitBinary, InRepositoryRoot, AppendPathspecFromFile(InParameters, PathspecFile), FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+			return bResult;
+		}
+	}
+
 	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
 	{
 		// Batch files up so we dont exceed command-line limits
@@ -934,35 +1611,148 @@ public:
 };
 
 /**
- * @brief Extract the relative filename from a Git status result.
+ * @brief Extract the status and the relative filename from the NUL-terminated records of a Git "status --porcelain -z" command.
  *
- * Examples of status results:
-M  Content/Textures/T_Perlin_Noise_M.uasset
-R  Content/Textures/T_Perlin_Noise_M.uasset -> Content/Textures/T_Perlin_Noise_M2.uasset
-?? Content/Materials/M_Basic_Wall.uasset
-!! BasicCode.sln
+ * Examples of status records (paths are never quoted nor escaped with -z):
+M  Content/Textures/T_Perlin_Noise_M.uasset\0
+R  Content/Textures/T_Perlin_Noise_M2.uasset\0Content/Textures/T_Perlin_Noise_M.uasset\0
+?? Content/Materials/M_Basic_Wall.uasset\0
+!! BasicCode.sln\0
  *
- * @param[in] InResult One line of status
- * @return Relative filename extracted from the line of status
+ * and of "status --porcelain=v2 --branch -z", where an unchanged side is a '.' instead of a ' ':
+# branch.oid 9e8c52ad6d4c5a3b8f6c7ad2b4ca5dcbb8f8f6b1\0
+# branch.head main\0
+# branch.upstream origin/main\0
+# branch.ab +1 -2\0
+1 .M N... 100644 100644 100644 d9b33098273547b57c0af314136f35b494e16dcb d9b33098273547b57c0af314136f35b494e16dcb Content/Textures/T_Perlin_Noise_M.uasset\0
+2 R. N... 100644 100644 100644 d9b33098273547b57c0af314136f35b494e16dcb d9b33098273547b57c0af314136f35b494e16dcb R100 Content/Textures/T_Perlin_Noise_M2.uasset\0Content/Textures/T_Perlin_Noise_M.uasset\0
+u UU N... 100644 100644 100644 100644 d9b33098273547b57c0af314136f35b494e16dcb a14347dc3b589b78fb19ba62a7e3982f343718bc f3137a7167c840847cd7bd2bf07eefbfb2d9bcd2 Content/Blueprints/BP_Test.uasset\0
+? Content/Materials/M_Basic_Wall.uasset\0
  *
- * @see FGitStatusFileMatcher and StateFromGitStatus()
+ * A rename or copy is followed by an extra record with the original path, which is skipped.
+ * With porcelain v2, the status letters are converted to the ones of porcelain v1, and the branch headers are collected.
+ *
+ * @see FGitStatusFileMatcher and FGitStatusParser
  */
-static FString FilenameFromGitStatus(const FString& InResult)
+class FGitStatusRecordParser
 {
-	int32 RenameIndex;
-	FString Result;
-	if (InResult.FindLastChar('>', RenameIndex))
+public:
+	explicit FGitStatusRecordParser(const bool bInPorcelainV2 = false)
+		: bPorcelainV2(bInPorcelainV2)
+	{}
+
+	/**
+	 * Split a record into its status letters and its path, without copying them.
+	 * @returns false if the record is not a status but the original path of the previous rename/copy record (or a header)
+	 */
+	bool Parse(const FStringView& InRecord, FStringView& OutStatus, FStringView& OutPath)
 	{
-		// Extract only the second part of a rename "from -> to"
-		Result = InResult.RightChop(RenameIndex + 2);
+		if (bOriginalPathExpected)
+		{
+			bOriginalPathExpected = false;
+			return false;
+		}
+		if (bPorcelainV2)
+		{
+			return ParseV2(InRecord, OutStatus, OutPath);
+		}
+		if (InRecord.Len() < 4)
+		{
+			return false;
+		}
+		// The relative filename is after the 2 letters status and 1 space
+		OutStatus = InRecord.Left(2);
+		OutPath = InRecord.RightChop(3);
+		bOriginalPathExpected = (OutStatus[0] == 'R') || (OutStatus[0] == 'C') || (OutStatus[1] == 'R') || (OutStatus[1] == 'C');
+		return true;
 	}
-	else
+
+	/** Position of the current branch, from the "--branch" headers */
+	const FGitBranchStatus& GetBranchStatus() const
 	{
-		// Extract the relative filename from the Git status result (after the 2 letters status and 1 space)
-		Result = InResult.RightChop(3);
+		return BranchStatus;
 	}
-	return Result.TrimQuotes();
-}
+
+private:
+	bool ParseV2(const FStringView& InRecord, FStringView& OutStatus, FStringView& OutPath)
+	{
+		if (InRecord.Len() < 3)
+		{
+			return false;
+		}
+		// Number of space-separated fields between the record type and the path
+		int32 NumFields;
+		switch (InRecord[0])
+		{
+		case '#':
+			ParseHeader(InRecord.RightChop(2));
+			return false;
+		case '?':
+		case '!':
+			StatusLetters[0] = StatusLetters[1] = InRecord[0];
+			OutStatus = FStringView(StatusLetters, 2);
+			OutPath = InRecord.RightChop(2);
+			return true;
+		case '1':
+			NumFields = 8;
+			break;
+		case '2':
+			NumFields = 9;
+			break;
+		case 'u':
+			NumFields = 10;
+			break;
+		default:
+			return false;
+		}
+		// The path is the last field, and can contain spaces
+		int32 PathIndex = 0;
+		for (int32 Field = 0; Field < NumFields; Field++)
+		{
+			int32 SpaceIndex;
+			if (!InRecord.RightChop(PathIndex).FindChar(TEXT(' '), SpaceIndex))
+			{
+				return false;
+			}
+			PathIndex += SpaceIndex + 1;
+		}
+		StatusLetters[0] = (InRecord[2] == '.') ? TEXT(' ') : InRecord[2];
+		StatusLetters[1] = (InRecord[3] == '.') ? TEXT(' ') : InRecord[3];
+		OutStatus = FStringView(StatusLetters, 2);
+		OutPath = InRecord.RightChop(PathIndex);
+		bOriginalPathExpected = (InRecord[0] == '2');
+		return true;
+	}
+
+	/** Parse "branch.upstream <upstream>" and "branch.ab +<ahead> -<behind>" */
+	void ParseHeader(const FStringView& InHeader)
+	{
+		static const FStringView UpstreamHeader(TEXT("branch.upstream "));
+		static const FStringView AheadBehindHeader(TEXT("branch.ab +"));
+		if (InHeader.StartsWith(UpstreamHeader))
+		{
+			BranchStatus.Upstream = FString(InHeader.RightChop(UpstreamHeader.Len()));
+		}
+		else if (InHeader.StartsWith(AheadBehindHeader))
+		{
+			const FString AheadBehind(InHeader.RightChop(AheadBehindHeader.Len()));
+			FString Ahead, Behind;
+			if (AheadBehind.Split(TEXT(" -"), &Ahead, &Behind))
+			{
+				BranchStatus.Ahead = FCString::Atoi(*Ahead);
+				BranchStatus.Behind = FCString::Atoi(*Behind);
+			}
+		}
+	}
+
+	bool bPorcelainV2;
+	bool bOriginalPathExpected = false;
+
+	/** Status letters converted from porcelain v2, referenced by the last parsed status */
+	TCHAR StatusLetters[2];
+
+	FGitBranchStatus BranchStatus;
+};
 
 /** Match the relative filename of a Git status result with a provided absolute filename */
 class FGitStatusFileMatcher
@@ -971,9 +1761,11 @@ public:
 	FGitStatusFileMatcher(const FString& InAbsoluteFilename) : AbsoluteFilename(InAbsoluteFilename)
 	{}
 
-	bool operator()(const FString& InResult) const
+	bool operator()(const FStringView& InRelativeFilename) const
 	{
-		return AbsoluteFilename.Contains(FilenameFromGitStatus(InResult));
+		// The relative filename must match whole path components at the end of the absolute filename
+		const int32 IdxSeparator = AbsoluteFilename.Len() - InRelativeFilename.Len() - 1;
+		return (IdxSeparator >= 0) && (AbsoluteFilename[IdxSeparator] == TEXT('/')) && FStringView(AbsoluteFilename).EndsWith(InRelativeFilename);
 	}
 
 private:
@@ -996,7 +1788,7 @@ private:
 class FGitStatusParser
 {
 public:
-	FGitStatusParser(const FString& InResult)
+	FGitStatusParser(const FStringView& InResult)
 	{
 		TCHAR IndexState = InResult[0];
 		TCHAR WCopyState = InResult[1];
@@ -1013,8 +1805,9 @@ public:
 		{
 			TreeState = ETreeState::Working;
 		}
-		else if (WCopyState == ' ')
+		else
 		{
+			// Staged, even if also modified in the working tree ("MM", "AM"...)
 			TreeState = ETreeState::Staged;
 		}
 
@@ -1066,7 +1859,7 @@ public:
 /**
  * Extract the status of a unmerged (conflict) file
  *
- * Example output of git ls-files --unmerged Content/Blueprints/BP_Test.uasset
+ * Example output of git ls-files --unmerged Content/Blueprints/BP_Test.uasset (NUL-terminated records with -z)
 100644 d9b33098273547b57c0af314136f35b494e16dcb 1	Content/Blueprints/BP_Test.uasset
 100644 a14347dc3b589b78fb19ba62a7e3982f343718bc 2	Content/Blueprints/BP_Test.uasset
 100644 f3137a7167c840847cd7bd2bf07eefbfb2d9bcd2 3	Content/Blueprints/BP_Test.uasset
@@ -1084,17 +1877,24 @@ public:
 		const FString& CommonAncestor = InResults[0]; // 1: The common ancestor of merged branches
 		CommonAncestorFileId = CommonAncestor.Mid(7, 40);
 #if !UE_VERSION_OLDER_THAN(5, 3, 0)
-		CommonAncestorFilename = CommonAncestor.Right(50);
+		CommonAncestorFilename = FilenameFromUnmergedRecord(CommonAncestor);
 
 		if (ensure(InResults.IsValidIndex(2)))
 		{
-			const FString& RemoteBranch = InResults[2]; // 1: The common ancestor of merged branches
+			const FString& RemoteBranch = InResults[2]; // 3: The version from the other branch
 			RemoteFileId = RemoteBranch.Mid(7, 40);
-			RemoteFilename = RemoteBranch.Right(50);
+			RemoteFilename = FilenameFromUnmergedRecord(RemoteBranch);
 		}
 #endif
 	}
 
+	/** The relative filename is after the tabulation: "<mode> <SHA1> <stage>\t<path>" */
+	static FString FilenameFromUnmergedRecord(const FString& InRecord)
+	{
+		int32 IdxTab;
+		return InRecord.FindChar('\t', IdxTab) ? InRecord.RightChop(IdxTab + 1) : FString();
+	}
+
 	FString CommonAncestorFileId; ///< SHA1 Id of the file (warning: not the commit Id)
 #if !UE_VERSION_OLDER_THAN(5, 3, 0)
 	FString RemoteFileId;		///< SHA1 Id of the file (warning: not the commit Id)
@@ -1104,28 +1904,57 @@ public:
 #endif
 };
 
-/** Execute a command to get the details of a conflict */
-static void RunGetConflictStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, FGitSourceControlState& InOutFileState)
+/**
+ * Execute a single command to get the details of the conflicts of all the provided files
+ * @param	InConflictedFiles	Absolute paths of the conflicted files, whose states are in InOutStates
+ */
+static void RunGetConflictStatuses(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InConflictedFiles, TMap<FString, FGitSourceControlState>& InOutStates)
 {
+	if (InConflictedFiles.Num() == 0)
+	{
+		return;
+	}
+
+	// List the stages of all unmerged files of the repository at once (without pathspecs, so one process whatever the number of conflicts),
+	// grouped by relative filename ("<mode> <SHA1> <stage>\t<path>", sorted by path and then by stage)
+	TMap<FString, TArray<FString>> UnmergedStages;
+	UnmergedStages.Reserve(InConflictedFiles.Num());
 	TArray<FString> ErrorMessages;
-	TArray<FString> Results;
-	TArray<FString> Files;
-	Files.Add(InFile);
 	TArray<FString> Parameters;
 	Parameters.Add(TEXT("--unmerged"));
-	bool bResult = RunCommandInternal(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, ErrorMessages);
-	if (bResult && Results.Num() == 3)
+	Parameters.Add(TEXT("-z"));
+	const bool bResult = RunCommandStreaming(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(),
+		[&UnmergedStages](FStringView Record)
+		{
+			int32 IdxTab;
+			if (Record.FindChar(TEXT('\t'), IdxTab))
+			{
+				UnmergedStages.FindOrAdd(FString(Record.RightChop(IdxTab + 1))).Emplace(Record);
+			}
+		}, ErrorMessages, '\0');
+	if (!bResult)
+	{
+		return;
+	}
+
+	for (const FString& File : InConflictedFiles)
 	{
-		// Parse the unmerge status: extract the base revision (or the other branch?)
-		FGitConflictStatusParser ConflictStatus(Results);
+		FGitSourceControlState* FileState = InOutStates.Find(File);
+		const TArray<FString>* Results = File.StartsWith(InRepositoryRoot) ? UnmergedStages.Find(File.RightChop(InRepositoryRoot.Len() + 1)) : nullptr;
+		if (FileState && Results && Results->Num() == 3)
+		{
+			// Parse the unmerge status: extract the base revision (or the other branch?)
+			FGitConflictStatusParser ConflictStatus(*Results);
 #if !UE_VERSION_OLDER_THAN(5, 3, 0)
-		InOutFileState.PendingResolveInfo.BaseFile = ConflictStatus.CommonAncestorFilename;
-		InOutFileState.PendingResolveInfo.BaseRevision = ConflictStatus.CommonAncestorFileId;
-		InOutFileState.PendingResolveInfo.RemoteFile = ConflictStatus.RemoteFilename;
-		InOutFileState.PendingResolveInfo.RemoteRevision = ConflictStatus.RemoteFileId;
+			ISourceControlState::FResolveInfo& PendingResolveInfo = FileState->MutableDetails().PendingResolveInfo;
+			PendingResolveInfo.BaseFile = ConflictStatus.CommonAncestorFilename;
+			PendingResolveInfo.BaseRevision = ConflictStatus.CommonAncestorFileId;
+			PendingResolveInfo.RemoteFile = ConflictStatus.RemoteFilename;
+			PendingResolveInfo.RemoteRevision = ConflictStatus.RemoteFileId;
 #else
-		InOutFileState.PendingMergeBaseFileHash = ConflictStatus.CommonAncestorFileId;
+			FileState->MutableDetails().PendingMergeBaseFileHash = ConflictStatus.CommonAncestorFileId;
 #endif
+		}
 	}
 }
 
@@ -1204,11 +2033,39 @@ void AbsoluteFilenames(const FString& InRepositoryRoot, TArray<FString>& InFileN
  */
 bool ListFilesInDirectoryRecurse(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles)
 {
+	// First enumerate the files from the index, without launching any Git process
+	if (InDirectory.StartsWith(InRepositoryRoot))
+	{
+		if (const TSharedPtr<const FGitIndex, ESPMode::ThreadSafe> Index = FGitIndexCache::Get().GetIndex(InRepositoryRoot))
+		{
+			FString RelativeDirectory = InDirectory.RightChop(InRepositoryRoot.Len());
+			RelativeDirectory.RemoveFromStart(TEXT("/"));
+			RelativeDirectory.RemoveFromEnd(TEXT("/"));
+			TArray<FString> RelativeFilenames;
+			Index->ListFiles(RelativeDirectory, RelativeFilenames);
+			// No file could also be a case mismatch with the index: let Git decide
+			if (RelativeFilenames.Num() > 0)
+			{
+				OutFiles.Reserve(OutFiles.Num() + RelativeFilenames.Num());
+				for (const FString& RelativeFilename : RelativeFilenames)
+				{
+					OutFiles.Add(FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename));
+				}
+				return true;
+			}
+		}
+	}
+
 	TArray<FString> ErrorMessages;
 	TArray<FString> Directory;
 	Directory.Add(InDirectory);
-	const bool bResult = RunCommandInternal(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, FGitSourceControlModule::GetEmptyStringArray(), Directory, OutFiles, ErrorMessages);
-	AbsoluteFilenames(InRepositoryRoot, OutFiles);
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("-z")); // NUL-terminated paths, neither quoted nor escaped
+	const bool bResult = RunCommandStreaming(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, Parameters, Directory,
+		[&InRepositoryRoot, &OutFiles](FStringView RelativeFilename)
+		{
+			OutFiles.Add(FPaths::ConvertRelativePathToFull(InRepositoryRoot, FString(RelativeFilename)));
+		}, ErrorMessages, '\0');
 	return bResult;
 }
 
@@ -1264,7 +2121,11 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 	TMap<FString, FString> Results = InResults;
 	bool bCheckedLockedFiles = false;
 
+	// Tell tracked files from untracked ones with the index, instead of checking each of them on disk
+	const TSharedPtr<const FGitIndex, ESPMode::ThreadSafe> Index = FGitIndexCache::Get().GetIndex(InRepositoryRoot);
+
 	FString Result;
+	TArray<FString> ConflictedFiles;
 
 	// Iterate on all files explicitly listed in the command
 	for (const auto& File : InFiles)
@@ -1286,15 +2147,22 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 			FileState.State.TreeState = StatusParser.TreeState;
 			if (FileState.IsConflicted())
 			{
-				// In case of a conflict (unmerged file) get the base revision to merge
-				RunGetConflictStatus(InPathToGitBinary, InRepositoryRoot, File, FileState);
+				// In case of a conflict (unmerged file) get the base revision to merge, for all conflicts at once below
+				ConflictedFiles.Add(File);
 			}
 		}
 		else
 		{
 			FileState.State.FileState = EFileState::Unknown;
 			// File not found in status
-			if (FPaths::FileExists(File))
+			if (Index.IsValid() && File.StartsWith(InRepositoryRoot) && Index->Find(FStringView(File).RightChop(InRepositoryRoot.Len() + 1)))
+			{
+				// tracked by Git, and not changed since it would else be listed by git status
+				FileState.State.TreeState = ETreeState::Unmodified;
+
+				UE_LOG(LogSourceControl, VeryVerbose, TEXT("Status(%s) not found but in index => unchanged"), *File);
+			}
+			else if (FPaths::FileExists(File))
 			{
 				// usually means the file is unchanged,
 				FileState.State.TreeState = ETreeState::Unmodified;
@@ -1329,8 +2197,9 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 				}
 				if (LockedFiles.Contains(File))
 				{
-					FileState.State.LockUser = LockedFiles[File];
-					if (LfsUserName == FileState.State.LockUser)
+					const FString& LockUser = LockedFiles[File];
+					FileState.State.LockUser = LockUser;
+					if (LfsUserName == LockUser)
 					{
 						FileState.State.LockState = ELockState::Locked;
 					}
@@ -1356,6 +2225,8 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 		OutStates.Add(File, MoveTemp(FileState));
 	}
 
+	RunGetConflictStatuses(InPathToGitBinary, InRepositoryRoot, ConflictedFiles, OutStates);
+
 	// The above cannot detect deleted assets since there is no file left to enumerate (either by the Content Browser or by git ls-files)
 	// => so we also parse the status results to explicitly look for Deleted/Missing assets
 	ParseDirectoryStatusResult(InUsingLfsLocking, Results, OutStates);
@@ -1387,69 +2258,279 @@ void ParseStatusResults(const FString& InPathToGitBinary, const FString& InRepos
 	ParseFileStatusResult(InPathToGitBinary, InRepositoryRoot, InUsingLfsLocking, Files, InResults, OutStates);
 }
 
-void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& Files,
-				 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
+/** Files changed on a remote branch by its commits that are not in HEAD yet, for one pair of commits */
+struct FRemoteBranchChanges
 {
-	// We can obtain a list of files that were modified between our remote branches and HEAD. Assumes that fetch has been run to get accurate info.
+	FString HeadCommitId;
+	FString TipCommitId;
 
-	// Gather valid remote branches
-	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
-	if (!GitSourceControl)
-	{
-		return;
-	}
-	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
-	const TArray<FString> StatusBranches = Provider.GetStatusBranchNames();
+	/** Paths relative to the root of the repository */
+	TArray<FString> Files;
+};
 
-	TSet<FString> BranchesToDiff{ StatusBranches };
+/**
+ * Files modified on the remote branches, as found by CheckRemote().
+ *
+ * The result is reused as long as the references of the repository do not change (see FGitRefsWatcher).
+ * When they change, only the branches whose tip or HEAD moved are searched again, and only the commits never seen before are diffed, since commits never change.
+ */
+struct FRemoteChangesCache
+{
+	FCriticalSection CriticalSection;
 
-	bool bDiffAgainstRemoteCurrent = false;
+	FString RepositoryRoot;
 
-	// Get the current branch's remote.
+	/** Generation of the references the result was computed for */
+	int32 RefsGeneration = INDEX_NONE;
+
+	/** Upstream of the current branch */
 	FString CurrentBranchName;
-	if (GetRemoteBranchName(InPathToGitBinary, InRepositoryRoot, CurrentBranchName))
-	{
-		// We have a valid remote, so diff against it.
-		bDiffAgainstRemoteCurrent = true;
-		// Ensure that the remote branch is in there.
-		BranchesToDiff.Add(CurrentBranchName);
+
+	/** Map of the absolute paths of the files to the newest branch modifying them */
+	TMap<FString, FString> NewerFiles;
+
+	/** Newer binaries were found on the upstream branch */
+	bool bPendingRestart = false;
+
+	/** Changes of each branch, by branch name */
+	TMap<FString, FRemoteBranchChanges> Branches;
+
+	/** Files changed by each commit of the remote branches (among the checked paths) */
+	TMap<FString, TArray<FString>> CommitFiles;
+};
+
+static FRemoteChangesCache RemoteChangesCache;
+
+// Resolve "HEAD" or a branch name ("origin/main") to a commit id, reading the references without launching Git when possible
+static bool ResolveCommitId(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FGitRefsReader& InRefs, const FString& InName, FString& OutCommitId)
+{
+	if (InRefs.IsValid())
+	{
+		if (InName == TEXT("HEAD"))
+		{
+			// The commit id is empty on an unborn branch
+			FString HeadRef;
+			if (InRefs.ReadHead(HeadRef, OutCommitId))
+			{
+				return true;
+			}
+		}
+		// Same order as Git to disambiguate a short name (but let Git peel the tags)
+		else if (!InRefs.ResolveRef(TEXT("refs/tags/") + InName, OutCommitId)
+			&& (InRefs.ResolveRef(TEXT("refs/") + InName, OutCommitId) || InRefs.ResolveRef(TEXT("refs/heads/") + InName, OutCommitId)
+				|| InRefs.ResolveRef(TEXT("refs/remotes/") + InName, OutCommitId)))
+		{
+			return true;
+		}
 	}
 
-	if (!BranchesToDiff.Num())
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Parameters{TEXT("--verify"), TEXT("--quiet"), InName + TEXT("^{commit}")};
+	if (RunCommand(TEXT("rev-parse"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages) && (InfoMessages.Num() > 0))
 	{
-		return;
+		OutCommitId = InfoMessages[0];
+		return true;
 	}
+	return false;
+}
 
+// Find the files changed on a branch between HEAD and its tip, only diffing the commits that are not in the cache yet
+static bool UpdateRemoteBranchChanges(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFilesToDiff, const FString& InHeadCommitId,
+									  const FString& InTipCommitId, TMap<FString, TArray<FString>>& InOutCommitFiles, FRemoteBranchChanges& OutChanges, TArray<FString>& OutErrorMessages)
+{
+	// Commits of the branch that are not in HEAD and change any of the files to diff (cheap: no diff, and uses the changed-path Bloom filters of the commit-graph when available)
+	TArray<FString> Commits;
+	TArray<FString> RevListParameters{InTipCommitId};
+	if (!InHeadCommitId.IsEmpty())
+	{
+		RevListParameters.Add(TEXT("^") + InHeadCommitId);
+	}
+	RevListParameters.Add(TEXT("--"));
 	TArray<FString> ErrorMessages;
+	if (!RunCommand(TEXT("rev-list"), InPathToGitBinary, InRepositoryRoot, RevListParameters, InFilesToDiff, Commits, ErrorMessages))
+	{
+		OutErrorMessages.Append(ErrorMessages);
+		return false;
+	}
 
-	TArray<FString> Results;
-	TMap<FString, FString> NewerFiles;
+	// Diff the new commits, by batches to keep the command line short
+	TArray<FString> NewCommits;
+	for (const FString& Commit : Commits)
+	{
+		if (!InOutCommitFiles.Contains(Commit))
+		{
+			NewCommits.Add(Commit);
+		}
+	}
+	for (int32 BatchStart = 0; BatchStart < NewCommits.Num(); BatchStart += GitSourceControlConstants::MaxFilesPerBatch)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + GitSourceControlConstants::MaxFilesPerBatch, NewCommits.Num());
+		TArray<FString> LogParameters{TEXT("--no-walk=unsorted"), TEXT("--pretty=format:%H"), TEXT("--name-only"), TEXT("-z")};
+		for (int32 CommitIndex = BatchStart; CommitIndex < BatchEnd; CommitIndex++)
+		{
+			LogParameters.Add(NewCommits[CommitIndex]);
+			// Add them all first, so that the map is not reallocated while parsing (commits that changed none of the files are not listed)
+			InOutCommitFiles.Add(NewCommits[CommitIndex]);
+		}
+		LogParameters.Add(TEXT("--"));
+
+		// Each commit is listed as "<id>\n<file>\0<file>\0...", commits being separated by an empty record; merge commits are listed as "<id>\0" without any file
+		TArray<FString>* CommitFiles = nullptr;
+		const bool bResult = RunCommandStreaming(TEXT("log"), InPathToGitBinary, InRepositoryRoot, LogParameters, InFilesToDiff,
+			[&InOutCommitFiles, &CommitFiles](FStringView Record)
+			{
+				int32 IdxNewLine;
+				int32 IdxSlash;
+				if (Record.FindChar(TEXT('\n'), IdxNewLine))
+				{
+					CommitFiles = InOutCommitFiles.Find(FString(Record.Left(IdxNewLine)));
+					Record.RightChopInline(IdxNewLine + 1);
+				}
+				else if (!Record.FindChar(TEXT('/'), IdxSlash))
+				{
+					if (TArray<FString>* MergeCommitFiles = InOutCommitFiles.Find(FString(Record)))
+					{
+						CommitFiles = MergeCommitFiles;
+						return;
+					}
+				}
+				if (CommitFiles && !Record.IsEmpty())
+				{
+					CommitFiles->Emplace(Record);
+				}
+			}, ErrorMessages, '\0');
+		if (!bResult)
+		{
+			for (int32 CommitIndex = BatchStart; CommitIndex < BatchEnd; CommitIndex++)
+			{
+				InOutCommitFiles.Remove(NewCommits[CommitIndex]);
+			}
+			OutErrorMessages.Append(ErrorMessages);
+			return false;
+		}
+	}
 
-	//const TArray<FString>& RelativeFiles = RelativeFilenames(Files, InRepositoryRoot);
-	// Get the full remote status of the Content folder, since it's the only lockable folder we track in editor. 
-	// This shows any new files as well.
-	// Also update the status of `.checksum`.
-	TArray<FString> FilesToDiff{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()), ".checksum", "Binaries/", "Plugins/"};
-	TArray<FString> ParametersLog{TEXT("--pretty="), TEXT("--name-only"), TEXT(""), TEXT("--")};
-	for (auto& Branch : BranchesToDiff)
+	TSet<FString> Files;
+	for (const FString& Commit : Commits)
 	{
-		bool bCurrentBranch;
-		if (bDiffAgainstRemoteCurrent && Branch.Equals(CurrentBranchName))
+		for (const FString& File : InOutCommitFiles.FindChecked(Commit))
 		{
-			bCurrentBranch = true;
+			Files.Add(File);
 		}
-		else
+	}
+	OutChanges.HeadCommitId = InHeadCommitId;
+	OutChanges.TipCommitId = InTipCommitId;
+	OutChanges.Files = Files.Array();
+	return true;
+}
+
+static void ApplyRemoteNewerFiles(const FString& InCurrentBranchName, const TMap<FString, FString>& InNewerFiles, TMap<FString, FGitSourceControlState>& OutStates)
+{
+	for (auto& FileState : OutStates)
+	{
+		if (const FString* NewerBranch = InNewerFiles.Find(FileState.Key))
 		{
-			bCurrentBranch = false;
+			FileState.Value.State.RemoteState = NewerBranch->Equals(InCurrentBranchName) ? ERemoteState::NotAtHead : ERemoteState::NotLatest;
+			FileState.Value.State.HeadBranch = *NewerBranch;
 		}
-		// empty defaults to HEAD
-		// .. means commits in the right that are not in the left
-		ParametersLog[2] = FString::Printf(TEXT("..%s"), *Branch);
+	}
+}
 
-		const bool bResultDiff = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, ParametersLog, FilesToDiff, Results, ErrorMessages);
-		if (bResultDiff)
+void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& Files,
+				 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
+{
+	// We can obtain a list of files that were modified between our remote branches and HEAD. Assumes that fetch has been run to get accurate info.
+
+	// Gather valid remote branches
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl)
+	{
+		return;
+	}
+	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
+
+	// Reuse the files found for the same references (read the generation first, so that a change during the search invalidates its result)
+	const int32 RefsGeneration = FGitRefsWatcher::Get().GetGeneration();
+	TMap<FString, FRemoteBranchChanges> CachedBranches;
+	TMap<FString, TArray<FString>> CommitFiles;
+	{
+		FScopeLock ScopeLock(&RemoteChangesCache.CriticalSection);
+		if (RemoteChangesCache.RepositoryRoot != InRepositoryRoot)
+		{
+			RemoteChangesCache.RepositoryRoot = InRepositoryRoot;
+			RemoteChangesCache.RefsGeneration = INDEX_NONE;
+			RemoteChangesCache.Branches.Empty();
+			RemoteChangesCache.CommitFiles.Empty();
+		}
+		if (RemoteChangesCache.RefsGeneration == RefsGeneration)
 		{
-			for (const FString& NewerFileName : Results)
+			if (RemoteChangesCache.bPendingRestart)
+			{
+				Provider.bPendingRestart = true;
+			}
+			ApplyRemoteNewerFiles(RemoteChangesCache.CurrentBranchName, RemoteChangesCache.NewerFiles, OutStates);
+			return;
+		}
+		// Search on a copy, so that the lock is not held while running Git
+		CachedBranches = RemoteChangesCache.Branches;
+		CommitFiles = RemoteChangesCache.CommitFiles;
+	}
+
+	const TArray<FString> StatusBranches = Provider.GetStatusBranchNames();
+
+	TSet<FString> BranchesToDiff{ StatusBranches };
+
+	bool bDiffAgainstRemoteCurrent = false;
+
+	// Get the current branch's remote.
+	FString CurrentBranchName;
+	if (GetRemoteBranchName(InPathToGitBinary, InRepositoryRoot, CurrentBranchName))
+	{
+		// We have a valid remote, so diff against it.
+		bDiffAgainstRemoteCurrent = true;
+		// Ensure that the remote branch is in there.
+		BranchesToDiff.Add(CurrentBranchName);
+	}
+
+	TArray<FString> ErrorMessages;
+
+	TMap<FString, FString> NewerFiles;
+	bool bPendingRestart = false;
+
+	TMap<FString, FRemoteBranchChanges> Branches;
+	const FGitRefsReader Refs(InRepositoryRoot);
+	FString HeadCommitId;
+	if (BranchesToDiff.Num() && ResolveCommitId(InPathToGitBinary, InRepositoryRoot, Refs, TEXT("HEAD"), HeadCommitId))
+	{
+		// Forget the files of old commits from time to time
+		if (CommitFiles.Num() > GitSourceControlConstants::MaxCachedRemoteCommits)
+		{
+			CommitFiles.Empty();
+			CachedBranches.Empty();
+		}
+
+		// Get the full remote status of the Content folder, since it's the only lockable folder we track in editor. 
+		// This shows any new files as well.
+		// Also update the status of `.checksum`.
+		const TArray<FString> FilesToDiff{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()), ".checksum", "Binaries/", "Plugins/"};
+		for (const FString& Branch : BranchesToDiff)
+		{
+			FString TipCommitId;
+			if (!ResolveCommitId(InPathToGitBinary, InRepositoryRoot, Refs, Branch, TipCommitId))
+			{
+				continue;
+			}
+			// Only search again the branches whose tip or HEAD moved
+			FRemoteBranchChanges Changes = CachedBranches.FindRef(Branch);
+			if (((Changes.HeadCommitId != HeadCommitId) || (Changes.TipCommitId != TipCommitId))
+				&& !UpdateRemoteBranchChanges(InPathToGitBinary, InRepositoryRoot, FilesToDiff, HeadCommitId, TipCommitId, CommitFiles, Changes, ErrorMessages))
+			{
+				continue;
+			}
+
+			const bool bCurrentBranch = bDiffAgainstRemoteCurrent && Branch.Equals(CurrentBranchName);
+			for (const FString& NewerFileName : Changes.Files)
 			{
 				// Don't care about mergeable files (.collection, .ini, .uproject, etc)
 				if (!IsFileLFSLockable(NewerFileName))
@@ -1458,30 +2539,46 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 					if (bCurrentBranch && (NewerFileName == TEXT(".checksum") || NewerFileName.StartsWith("Binaries/", ESearchCase::IgnoreCase) ||
 						NewerFileName.StartsWith("Plugins/", ESearchCase::IgnoreCase)))
 					{
-						Provider.bPendingRestart = true;
+						bPendingRestart = true;
 					}
 					continue;
 				}
-				const FString& NewerFilePath = FPaths::ConvertRelativePathToFull(InRepositoryRoot, NewerFileName);
+				FString NewerFilePath = FPaths::ConvertRelativePathToFull(InRepositoryRoot, NewerFileName);
 				if (bCurrentBranch || !NewerFiles.Contains(NewerFilePath))
 				{
-					NewerFiles.Add(NewerFilePath, Branch);
+					NewerFiles.Add(MoveTemp(NewerFilePath), Branch);
 				}
 			}
+			Branches.Add(Branch, MoveTemp(Changes));
 		}
-		Results.Reset();
 	}
 
-	for (const auto& NewFile : NewerFiles)
+	if (bPendingRestart)
 	{
-		if (FGitSourceControlState* FileState = OutStates.Find(NewFile.Key))
+		Provider.bPendingRestart = true;
+	}
+
+	ApplyRemoteNewerFiles(CurrentBranchName, NewerFiles, OutStates);
+
+	if (ErrorMessages.Num() > 0)
+	{
+		OutErrorMessages.Append(ErrorMessages);
+	}
+
+	FScopeLock ScopeLock(&RemoteChangesCache.CriticalSection);
+	// Another repository could have been searched meanwhile; a search for older references is replaced by the next one, its generation being outdated
+	if (RemoteChangesCache.RepositoryRoot == InRepositoryRoot)
+	{
+		RemoteChangesCache.Branches = MoveTemp(Branches);
+		RemoteChangesCache.CommitFiles = MoveTemp(CommitFiles);
+		if (ErrorMessages.Num() == 0)
 		{
-			FileState->State.RemoteState = NewFile.Value.Equals(CurrentBranchName) ? ERemoteState::NotAtHead : ERemoteState::NotLatest;
-			FileState->State.HeadBranch = NewFile.Value;
+			RemoteChangesCache.RefsGeneration = RefsGeneration;
+			RemoteChangesCache.CurrentBranchName = MoveTemp(CurrentBranchName);
+			RemoteChangesCache.NewerFiles = MoveTemp(NewerFiles);
+			RemoteChangesCache.bPendingRestart = bPendingRestart;
 		}
 	}
-
-	OutErrorMessages.Append(ErrorMessages);
 }
 
 const FTimespan CacheLimit = FTimespan::FromSeconds(30);
@@ -1599,11 +2696,41 @@ void GetLockedFiles(const TArray<FString>& InFiles, TArray<FString>& OutFiles)
 	}
 }
 
-FString GetFullPathFromGitStatus(const FString& Result, const FString& InRepositoryRoot)
+/** Changelist of a file according to its state: Staged (also for untracked and conflicted files), Working, or none (unchanged files) */
+static const FGitSourceControlChangelist* GetChangelistOfState(const FGitState& InState)
 {
-	const FString& RelativeFilename = FilenameFromGitStatus(Result);
-	FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename);
-	return File;
+	if ((InState.TreeState == ETreeState::Staged) || (InState.TreeState == ETreeState::Untracked) || (InState.FileState == EFileState::Unmerged))
+	{
+		return &FGitSourceControlChangelist::StagedChangelist;
+	}
+	if (InState.TreeState == ETreeState::Working)
+	{
+		return &FGitSourceControlChangelist::WorkingChangelist;
+	}
+	return nullptr;
+}
+
+/** Move the state of a file to another changelist (or out of any changelist), only touching the file lists of the changelists when it actually moves */
+static void MoveStateToChangelist(FGitSourceControlProvider& Provider, const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState, const FGitSourceControlChangelist* InChangelist)
+{
+	const bool bWasInChangelist = InState->Changelist.IsInitialized();
+	if (bWasInChangelist && InChangelist && (InState->Changelist == *InChangelist))
+	{
+		return;
+	}
+	if (bWasInChangelist)
+	{
+		Provider.GetStateInternal(InState->Changelist)->Files.RemoveSingle(InState);
+	}
+	if (InChangelist)
+	{
+		InState->Changelist = *InChangelist;
+		Provider.GetStateInternal(*InChangelist)->Files.Add(InState);
+	}
+	else if (bWasInChangelist)
+	{
+		InState->Changelist.Reset();
+	}
 }
 
 bool UpdateChangelistStateByCommand()
@@ -1624,10 +2751,6 @@ bool UpdateChangelistStateByCommand()
 	{
 		return false;
 	}
-	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> StagedChangelist = Provider.GetStateInternal(FGitSourceControlChangelist::StagedChangelist);
-	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> WorkingChangelist = Provider.GetStateInternal(FGitSourceControlChangelist::WorkingChangelist);
-	StagedChangelist->Files.Empty();
-	WorkingChangelist->Files.Empty();
 
 	TArray<FString> Files;
     // Provide the full path to the Content directory as relative paths assume the repository root is the project directory,
@@ -1635,36 +2758,126 @@ bool UpdateChangelistStateByCommand()
 	Files.Add(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()));
 	TArray<FString> Parameters;
 	Parameters.Add(TEXT("--porcelain"));
-	TArray<FString> Results;
+	Parameters.Add(TEXT("-z"));
 	TArray<FString> ErrorMsg;
-	const bool bResult = RunCommand(TEXT("--no-optional-locks status"), Provider.GetGitBinaryPath(), Provider.GetPathToRepositoryRoot(), Parameters, Files, Results, ErrorMsg);
-	for (const auto& Result : Results)
-	{
-		FString File = GetFullPathFromGitStatus(Result, Provider.GetPathToRepositoryRoot());
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(File);
-		// Staged check
-		if (!TChar<TCHAR>::IsWhitespace(Result[0]))
-		{
-			WorkingChangelist->Files.Remove(State);
-			UpdateFileStagingOnSavedInternal(Result);
-			State->Changelist = FGitSourceControlChangelist::StagedChangelist;
-			StagedChangelist->Files.AddUnique(State);
-			continue;
-		}
-		// Working check
-		if (!TChar<TCHAR>::IsWhitespace(Result[1]))
+	FGitStatusRecordParser RecordParser;
+	TSet<FString> ChangedFiles;
+	const bool bResult = RunCommandStreaming(TEXT("--no-optional-locks status"), Provider.GetGitBinaryPath(), Provider.GetPathToRepositoryRoot(), Parameters, Files,
+		[&Provider, &RecordParser, &ChangedFiles](FStringView Record)
+	{
+		FStringView Status, RelativeFilename;
+		if (!RecordParser.Parse(Record, Status, RelativeFilename))
 		{
-			StagedChangelist->Files.Remove(State);
-			State->Changelist = FGitSourceControlChangelist::WorkingChangelist;
-			WorkingChangelist->Files.AddUnique(State);
+			return;
 		}
+		const FGitStatusParser StatusParser(Status);
+		FGitState NewState;
+		NewState.FileState = StatusParser.FileState;
+		NewState.TreeState = StatusParser.TreeState;
+		FString File = FPaths::ConvertRelativePathToFull(Provider.GetPathToRepositoryRoot(), FString(RelativeFilename));
+		MoveStateToChangelist(Provider, Provider.GetStateInternal(File), GetChangelistOfState(NewState));
+		ChangedFiles.Add(MoveTemp(File));
+	}, ErrorMsg, '\0');
+	if (!bResult)
+	{
+		return true;
+	}
+
+	// Files that are not changed anymore leave the changelists
+	for (const FGitSourceControlChangelist* Changelist : { &FGitSourceControlChangelist::StagedChangelist, &FGitSourceControlChangelist::WorkingChangelist })
+	{
+		Provider.GetStateInternal(*Changelist)->Files.RemoveAll([&ChangedFiles](const FSourceControlStateRef& InState)
+		{
+			if (ChangedFiles.Contains(InState->GetFilename()))
+			{
+				return false;
+			}
+			StaticCastSharedRef<FGitSourceControlState>(InState)->Changelist.Reset();
+			return true;
+		});
 	}
 	return true;
 }
 	
+/**
+ * Filter out the files that are unchanged both in the working tree (compared to the index, with its cached stat data)
+ * and in the index (compared to HEAD, with the cache tree of their directory), so that git status only has to check the others.
+ * Directories, unknown files and racily clean files are always kept.
+ */
+static void FilterUnchangedFiles(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutFilesToStatus)
+{
+	const TSharedPtr<const FGitIndex, ESPMode::ThreadSafe> Index = FGitIndexCache::Get().GetIndex(InRepositoryRoot);
+	if (!Index.IsValid())
+	{
+		OutFilesToStatus = InFiles;
+		return;
+	}
+
+	// Files unchanged in the working tree, and the cached tree of their directory
+	TArray<int32> UnchangedFiles;
+	TArray<FString> UnchangedFileDirectories;
+	TMap<FString, FString> DirectoryTrees;
+	for (int32 FileIndex = 0; FileIndex < InFiles.Num(); FileIndex++)
+	{
+		const FString& File = InFiles[FileIndex];
+		if ((File.Len() > InRepositoryRoot.Len() + 1) && (File[InRepositoryRoot.Len()] == TEXT('/')))
+		{
+			const FStringView RelativeFilename = FStringView(File).RightChop(InRepositoryRoot.Len() + 1);
+			const FGitIndexEntry* Entry = Index->Find(RelativeFilename);
+			if (Entry && Index->IsUnchanged(*Entry, File))
+			{
+				const FString RelativeDirectory = FPaths::GetPath(Entry->Path);
+				FString TreeHash;
+				if (Index->GetTreeHash(RelativeDirectory, TreeHash))
+				{
+					DirectoryTrees.Add(RelativeDirectory, MoveTemp(TreeHash));
+					UnchangedFiles.Add(FileIndex);
+					UnchangedFileDirectories.Add(RelativeDirectory);
+					continue;
+				}
+			}
+		}
+		OutFilesToStatus.Add(File);
+	}
+	if (UnchangedFiles.Num() == 0)
+	{
+		return;
+	}
+
+	// Nothing is staged in a directory if its cached tree is the one of HEAD: ask them all at once to the persistent "cat-file --batch-check" process
+	TArray<FString> Directories;
+	TArray<FString> HeadTreeNames;
+	for (const auto& DirectoryTree : DirectoryTrees)
+	{
+		Directories.Add(DirectoryTree.Key);
+		HeadTreeNames.Add(TEXT("HEAD:") + DirectoryTree.Key);
+	}
+	TArray<FGitObjectInfo> HeadTrees;
+	TSet<FString> UnstagedDirectories;
+	if (FGitCatFilePool::Get().GetObjectInfos(InPathToGitBinary, InRepositoryRoot, HeadTreeNames, HeadTrees) && (HeadTrees.Num() == Directories.Num()))
+	{
+		for (int32 DirectoryIndex = 0; DirectoryIndex < Directories.Num(); DirectoryIndex++)
+		{
+			if (HeadTrees[DirectoryIndex].IsValid() && HeadTrees[DirectoryIndex].Hash.Equals(DirectoryTrees[Directories[DirectoryIndex]]))
+			{
+				UnstagedDirectories.Add(Directories[DirectoryIndex]);
+			}
+		}
+	}
+	for (int32 UnchangedIndex = 0; UnchangedIndex < UnchangedFiles.Num(); UnchangedIndex++)
+	{
+		if (!UnstagedDirectories.Contains(UnchangedFileDirectories[UnchangedIndex]))
+		{
+			OutFilesToStatus.Add(InFiles[UnchangedFiles[UnchangedIndex]]);
+		}
+	}
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("RunUpdateStatus: %d/%d files unchanged according to the index"), InFiles.Num() - OutFilesToStatus.Num(), InFiles.Num());
+}
+
 // Run a batch of Git "status" command to update status of given files and/or directories.
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking, const TArray<FString>& InFiles,
-					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
+					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates, FGitBranchStatus* OutBranchStatus /* = nullptr */)
 {
 	// Remove files that aren't in the repository
 	const TArray<FString>& RepoFiles = InFiles.FilterByPredicate([InRepositoryRoot](const FString& File) { return File.StartsWith(InRepositoryRoot); });
@@ -1674,32 +2887,90 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InReposito
 		return false;
 	}
 
+	// Files that the index tells are unchanged do not need to be given to git status
+	TArray<FString> FilesToStatus;
+	FilterUnchangedFiles(InPathToGitBinary, InRepositoryRoot, RepoFiles, FilesToStatus);
+
+	// The position of the current branch comes with the status: make sure to run it even if all the files are unchanged (with a single file it is cheap)
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	const bool bBranchStatus = (OutBranchStatus != nullptr) && GitSourceControl && GitSourceControl->GetProvider().GetGitVersion().bHasStatusPorcelainV2;
+	if (bBranchStatus && (FilesToStatus.Num() == 0))
+	{
+		FilesToStatus.Add(RepoFiles[0]);
+	}
+
 	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--porcelain"));
+	if (bBranchStatus)
+	{
+		Parameters.Add(TEXT("--porcelain=v2"));
+		Parameters.Add(TEXT("--branch")); // "# branch.upstream" and "# branch.ab" headers with the ahead/behind counts
+	}
+	else
+	{
+		Parameters.Add(TEXT("--porcelain"));
+	}
+	Parameters.Add(TEXT("-z")); // NUL-terminated records, with paths neither quoted nor escaped
 	Parameters.Add(TEXT("-uall")); // make sure we use -uall to list all files instead of directories
 	// We skip checking ignored since no one ignores files that Unreal would read in as revision controlled (Content/{*.uasset,*.umap},Config/*.ini).
-	TArray<FString> Results;
-	// avoid locking the index when not needed (useful for status updates)
-	const bool bResult = RunCommand(TEXT("--no-optional-locks status"), InPathToGitBinary, InRepositoryRoot, Parameters, RepoFiles, Results, OutErrorMessages);
+	// Map the absolute filenames to their two letters status
 	TMap<FString, FString> ResultsMap;
-	for (const auto& Result : Results)
-	{
-		const FString& RelativeFilename = FilenameFromGitStatus(Result);
-		const FString& File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename);
-		ResultsMap.Add(File, Result);
-	}
+	FGitStatusRecordParser RecordParser(bBranchStatus);
+	// avoid locking the index when not needed (useful for status updates)
+	const bool bResult = (FilesToStatus.Num() == 0) || RunCommandStreaming(TEXT("--no-optional-locks status"), InPathToGitBinary, InRepositoryRoot, Parameters, FilesToStatus,
+		[&InRepositoryRoot, &ResultsMap, &RecordParser](FStringView Record)
+		{
+			FStringView Status, RelativeFilename;
+			if (RecordParser.Parse(Record, Status, RelativeFilename))
+			{
+				ResultsMap.Add(FPaths::ConvertRelativePathToFull(InRepositoryRoot, FString(RelativeFilename)), FString(Status));
+			}
+		}, OutErrorMessages, '\0');
 	if (bResult)
 	{
 		ParseStatusResults(InPathToGitBinary, InRepositoryRoot, InUsingLfsLocking, RepoFiles, ResultsMap, OutStates);
+		if (bBranchStatus)
+		{
+			*OutBranchStatus = RecordParser.GetBranchStatus();
+		}
 	}
-	
-	UpdateChangelistStateByCommand();
 
 	CheckRemote(InPathToGitBinary, InRepositoryRoot, RepoFiles, OutErrorMessages, OutStates);
 
 	return bResult;
 }
 
+// Run a Git "status" command on the project directories, or only on the paths changed since the last one
+bool RunUpdateStatusOfProject(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking,
+							  TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
+{
+	const TArray<FString> ProjectDirs{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),
+									  FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
+									  FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath())};
+	TArray<FString> Paths;
+	FGitWorkingTreeBaseline Baseline;
+	const bool bIncremental = FGitWorkingTreeWatcher::Get().BeginStatus(InRepositoryRoot, ProjectDirs, Paths, Baseline);
+	const double StartTime = FPlatformTime::Seconds();
+	FGitBranchStatus BranchStatus;
+	const bool bResult = RunUpdateStatus(InPathToGitBinary, InRepositoryRoot, InUsingLfsLocking, Paths, OutErrorMessages, OutStates, &BranchStatus);
+	FGitWorkingTreeWatcher::Get().EndStatus(bResult, !bIncremental, Paths, Baseline);
+
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (bResult && GitSourceControl)
+	{
+		FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
+		if (InRepositoryRoot == Provider.GetPathToRepositoryRoot())
+		{
+			Provider.SetBranchStatus(BranchStatus);
+		}
+		// Measure the full statuses, to compare them with and without acceleration
+		if (!bIncremental)
+		{
+			Provider.RecordFullStatusTime(!Provider.GetStatusAccelerationOptions().IsEmpty(), FPlatformTime::Seconds() - StartTime);
+		}
+	}
+	return bResult;
+}
+
 void UpdateFileStagingOnSaved(const FString& Filename, UPackage* Pkg, FObjectPostSaveContext ObjectSaveContext)
 {
 	UpdateFileStagingOnSavedInternal(Filename);
@@ -1738,12 +3009,14 @@ void UpdateStateOnAssetRename(const FAssetData& InAssetData, const FString& InOl
 	}
 	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(InOldName);	
 	
-	State->LocalFilename = InAssetData.GetObjectPathString();
+	Provider.RenameStateInternal(State, InAssetData.GetObjectPathString());
 }
 
 // Run a Git `cat-file --filters` command to dump the binary content of a revision into a file.
 bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName)
 {
+	// Not read by the persistent "cat-file --batch" processes: with "--filters", the size given in the header is the size of the raw blob (ie. the LFS pointer),
+	// not of the filtered content written after it, so a one-shot process is used to get the content of the asset
 	int32 ReturnCode = -1;
 	FString FullCommand;
 
@@ -1775,30 +3048,7 @@ bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepository
 
 	UE_LOG(LogSourceControl, Log, TEXT("RunDumpToFile: 'git %s'"), *FullCommand);
 
-    FString PathToGitOrEnvBinary = InPathToGitBinary;
-    #if PLATFORM_MAC
-        // The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
-        FString PathEnv = FPlatformMisc::GetEnvironmentVariable(TEXT("PATH"));
-        FString GitInstallPath = FPaths::GetPath(InPathToGitBinary);
-
-        TArray<FString> PathArray;
-        PathEnv.ParseIntoArray(PathArray, FPlatformMisc::GetPathVarDelimiter());
-        bool bHasGitInstallPath = false;
-        for (auto Path : PathArray)
-        {
-            if (GitInstallPath.Equals(Path, ESearchCase::CaseSensitive))
-            {
-                bHasGitInstallPath = true;
-                break;
-            }
-        }
-
-        if (!bHasGitInstallPath)
-        {
-            PathToGitOrEnvBinary = FString("/usr/bin/env");
-            FullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *GitInstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToGitBinary, *FullCommand);
-        }
-    #endif
+	const FString PathToGitOrEnvBinary = GetGitLaunchExecutable(InPathToGitBinary, FullCommand);
 
 #if 0
 	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*PathToGitOrEnvBinary, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, *InRepositoryRoot, PipeWrite, nullptr, nullptr);
@@ -1967,6 +3217,9 @@ Date:   2014-2015-05-15 21:32:27 +0200
 M	Content/Blueprints/Blueprint_CeilingLight.uasset
 R100	Content/Textures/T_Concrete_Poured_D.uasset Content/Textures/T_Concrete_Poured_D2.uasset
 
+or with the --raw format, giving the full blob id of the file at this revision:
+:100644 100644 a14347dc3b589b78fb19ba62a7e3982f343718bc 6a8e6dc7e4c3ab8fd16b1bbb7f3a0a1ea37f1bd2 M	Content/Blueprints/Blueprint_CeilingLight.uasset
+
 commit 355f0df26ebd3888adbb558fd42bb8bd3e565000
 Author: Sébastien Rombauts <sebastien.rombauts@gmail.com>
 Date:   2014-2015-05-12 11:28:14 +0200
@@ -1976,10 +3229,48 @@ Date:   2014-2015-05-12 11:28:14 +0200
 A	Content/Blueprints/Blueprint_CeilingLight.uasset
 C099	Content/Textures/T_Concrete_Poured_N.uasset Content/Textures/T_Concrete_Poured_N2.uasset
 */
-static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlHistory& OutHistory)
+class FGitLogParser
 {
-	TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
-	for (const auto& Result : InResults)
+public:
+	FGitLogParser(TGitSourceControlHistory& InOutHistory)
+		: OutHistory(InOutHistory)
+		, SourceControlRevision(MakeShareable(new FGitSourceControlRevision))
+	{
+	}
+
+	/**
+	 * Parse one NUL-terminated record of the results of the 'git log --raw -z' command
+	 *
+	 * The header and message lines of a commit are separated by newlines, up to the modes, blob ids and status of the first file,
+	 * followed by one record with the name of the file (two for renames and copies), the next modes and status, etc.
+	 */
+	void ParseRecord(FStringView Record)
+	{
+		if (NumPathsExpected > 0)
+		{
+			// The last one is the name of the file at this revision (in case of a rename or copy)
+			SourceControlRevision->Filename = Record; // relative filename
+			NumPathsExpected--;
+			return;
+		}
+
+		while (Record.Len() > 0)
+		{
+			int32 IdxNewLine;
+			if (!Record.FindChar('\n', IdxNewLine))
+			{
+				IdxNewLine = Record.Len();
+			}
+			if (IdxNewLine > 0)
+			{
+				ParseLine(Record.Left(IdxNewLine));
+			}
+			Record.RightChopInline(IdxNewLine + 1);
+		}
+	}
+
+	/** Parse one line of the results of the 'git log' command */
+	void ParseLine(const FStringView& Result)
 	{
 		if (Result.StartsWith(TEXT("commit "))) // Start of a new commit
 		{
@@ -1999,7 +3290,7 @@ static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlH
 		else if (Result.StartsWith(TEXT("Author: "))) // Author name & email
 		{
 			// Remove the 'email' part of the UserName
-			FString UserNameEmail = Result.RightChop(8);
+			const FStringView UserNameEmail = Result.RightChop(8);
 			int32 EmailIndex = 0;
 			if (UserNameEmail.FindLastChar('<', EmailIndex))
 			{
@@ -2008,15 +3299,34 @@ static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlH
 		}
 		else if (Result.StartsWith(TEXT("Date:   "))) // Commit date
 		{
-			FString Date = Result.RightChop(8);
+			const FString Date(Result.RightChop(8));
 			SourceControlRevision->Date = FDateTime::FromUnixTimestamp(FCString::Atoi(*Date));
 		}
-		//	else if(Result.IsEmpty()) // empty line before/after commit message has already been taken care by FString::ParseIntoArray()
+		//	else if(Result.IsEmpty()) // empty line before/after commit message are skipped by the line reader
 		else if (Result.StartsWith(TEXT("    "))) // Multi-lines commit message
 		{
 			SourceControlRevision->Description += Result.RightChop(4);
 			SourceControlRevision->Description += TEXT("\n");
 		}
+		else if (Result.StartsWith(TEXT(":"))) // Raw diff: modes, full blob ids, status letter and name of the file
+		{
+			// ":100644 100644 <old blob id> <new blob id> M\tContent/File.uasset" (or "R100\tOld.uasset\tNew.uasset")
+			int32 IdxTab;
+			if (Result.FindChar('\t', IdxTab))
+			{
+				ParseRawDiff(Result.Left(IdxTab));
+				if (Result.FindLastChar('\t', IdxTab))
+				{
+					SourceControlRevision->Filename = Result.RightChop(IdxTab + 1); // relative filename
+				}
+			}
+			else
+			{
+				// With -z, the name(s) of the file are in the next record(s)
+				const TCHAR Status = ParseRawDiff(Result);
+				NumPathsExpected = ((Status == TEXT('R')) || (Status == TEXT('C'))) ? 2 : 1;
+			}
+		}
 		else // Name of the file, starting with an uppercase status letter ("A"/"M"...)
 		{
 			const TCHAR Status = Result[0];
@@ -2029,64 +3339,91 @@ static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlH
 			}
 		}
 	}
-	// End of the last commit
-	if (SourceControlRevision->RevisionNumber != 0)
-	{
-		OutHistory.Add(MoveTemp(SourceControlRevision));
-	}
 
-	// Then set the revision number of each Revision based on its index (reverse order since the log starts with the most recent change)
-	for (int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
+	/** End of the results: add the last commit and number all the revisions */
+	void Finish()
 	{
-		const auto& SourceControlRevisionItem = OutHistory[RevisionIndex];
-		SourceControlRevisionItem->RevisionNumber = OutHistory.Num() - RevisionIndex;
+		// End of the last commit
+		if (SourceControlRevision->RevisionNumber != 0)
+		{
+			OutHistory.Add(MoveTemp(SourceControlRevision));
+			SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
+		}
 
-		// Special case of a move ("branch" in Perforce term): point to the previous change (so the next one in the order of the log)
-		if ((SourceControlRevisionItem->Action == "branch") && (RevisionIndex < OutHistory.Num() - 1))
+		// Then set the revision number of each Revision based on its index (reverse order since the log starts with the most recent change)
+		for (int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
 		{
-			SourceControlRevisionItem->BranchSource = OutHistory[RevisionIndex + 1];
+			const auto& SourceControlRevisionItem = OutHistory[RevisionIndex];
+			SourceControlRevisionItem->RevisionNumber = OutHistory.Num() - RevisionIndex;
+
+			// Special case of a move ("branch" in Perforce term): point to the previous change (so the next one in the order of the log)
+			if ((SourceControlRevisionItem->Action == "branch") && (RevisionIndex < OutHistory.Num() - 1))
+			{
+				SourceControlRevisionItem->BranchSource = OutHistory[RevisionIndex + 1];
+			}
 		}
 	}
-}
 
-/**
- * Extract the SHA1 identifier and size of a blob (file) from a Git "ls-tree" command.
- *
- * Example output for the command git ls-tree --long 7fdaeb2 Content/Blueprints/BP_Test.uasset
-100644 blob a14347dc3b589b78fb19ba62a7e3982f343718bc   70731	Content/Blueprints/BP_Test.uasset
-*/
-class FGitLsTreeParser
-{
-public:
-	/** Parse the unmerge status: extract the base SHA1 identifier of the file */
-	FGitLsTreeParser(const TArray<FString>& InResults)
-	{
-		const FString& FirstResult = InResults[0];
-		FileHash = FirstResult.Mid(12, 40);
-		int32 IdxTab;
-		if (FirstResult.FindChar('\t', IdxTab))
-		{
-			const FString SizeString = FirstResult.Mid(53, IdxTab - 53);
-			FileSize = FCString::Atoi(*SizeString);
+private:
+	/**
+	 * Parse the "<old mode> <new mode> <old blob id> <new blob id> <status>" fields of a raw diff
+	 * @returns the status letter of the file
+	 */
+	TCHAR ParseRawDiff(FStringView InFields)
+	{
+		InFields.RightChopInline(1); // ':'
+		FStringView Fields[5];
+		int32 NumFields = 0;
+		int32 IdxSpace;
+		while ((NumFields < 4) && InFields.FindChar(' ', IdxSpace))
+		{
+			Fields[NumFields++] = InFields.Left(IdxSpace);
+			InFields.RightChopInline(IdxSpace + 1);
+		}
+		Fields[NumFields++] = InFields;
+		if ((NumFields == 5) && !Fields[4].IsEmpty())
+		{
+			SourceControlRevision->Action = LogStatusToString(Fields[4][0]);
+			// The blob id of a deleted file is all zeros
+			if (!Fields[3].StartsWith(TEXT("0000000000")))
+			{
+				SourceControlRevision->FileHash = Fields[3];
+			}
+			return Fields[4][0];
 		}
+		return TEXT('\0');
 	}
 
-	FString FileHash; ///< SHA1 Id of the file (warning: not the commit Id)
-	int32 FileSize; ///< Size of the file (in bytes)
+	TGitSourceControlHistory& OutHistory;
+	TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision;
+
+	/** Number of NUL-terminated records with the name of a file expected after the raw diff of a revision */
+	int32 NumPathsExpected = 0;
 };
 
+static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlHistory& OutHistory)
+{
+	FGitLogParser LogParser(OutHistory);
+	for (const auto& Result : InResults)
+	{
+		LogParser.ParseLine(Result);
+	}
+	LogParser.Finish();
+}
+
 // Run a Git "log" command and parse it.
 bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict,
 				   TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory)
 {
 	bool bResults;
 	{
-		TArray<FString> Results;
 		TArray<FString> Parameters;
 		Parameters.Add(TEXT("--follow")); // follow file renames
 		Parameters.Add(TEXT("--date=raw"));
-		Parameters.Add(TEXT("--name-status")); // relative filename at this revision, preceded by a status character
-		Parameters.Add(TEXT("--pretty=medium")); // make sure format matches expected in ParseLogResults
+		Parameters.Add(TEXT("--raw")); // relative filename at this revision, preceded by the full blob ids and a status character
+		Parameters.Add(TEXT("--no-abbrev"));
+		Parameters.Add(TEXT("-z")); // NUL-terminated filenames, neither quoted nor escaped
+		Parameters.Add(TEXT("--pretty=medium")); // make sure format matches expected in FGitLogParser
 		if (bMergeConflict)
 		{
 			// In case of a merge conflict, we also need to get the tip of the "remote branch" (MERGE_HEAD) before the log of the "current branch" (HEAD)
@@ -2100,29 +3437,109 @@ bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepository
 		}
 		TArray<FString> Files;
 		Files.Add(*InFile);
-		bResults = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, OutErrorMessages);
-		if (bResults)
+		// Parse the log while it is produced
+		FGitLogParser LogParser(OutHistory);
+		bResults = RunCommandStreaming(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, [&LogParser](FStringView Record) { LogParser.ParseRecord(Record); }, OutErrorMessages, '\0');
+		LogParser.Finish();
+	}
+
+	// Merge commits have no raw diff entry (neither -m nor --cc): get the blob id and size of the file at these commits
+	// in one round-trip of "<commit>:<path>" names to the persistent "cat-file --batch-check" process
+	TArray<FString> MergeObjectNames;
+	TArray<int32> MergeRevisionIndexes;
+	for (int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
+	{
+		const auto& Revision = OutHistory[RevisionIndex];
+		if (!Revision->FileHash.IsEmpty() || Revision->CommitId.IsEmpty())
 		{
-			ParseLogResults(Results, OutHistory);
+			continue;
+		}
+		if (Revision->Filename.IsEmpty())
+		{
+			// A merge does not rename the file: use its name at the closest older revision, else at the closest newer one
+			for (int32 OtherIndex = RevisionIndex + 1; (OtherIndex < OutHistory.Num()) && Revision->Filename.IsEmpty(); OtherIndex++)
+			{
+				Revision->Filename = OutHistory[OtherIndex]->Filename;
+			}
+			for (int32 OtherIndex = RevisionIndex - 1; (OtherIndex >= 0) && Revision->Filename.IsEmpty(); OtherIndex--)
+			{
+				Revision->Filename = OutHistory[OtherIndex]->Filename;
+			}
+			if (Revision->Filename.IsEmpty())
+			{
+				Revision->Filename = InFile;
+				FPaths::MakePathRelativeTo(Revision->Filename, *(InRepositoryRoot / TEXT("")));
+			}
 		}
+		MergeObjectNames.Add(Revision->CommitId + TEXT(":") + Revision->Filename);
+		MergeRevisionIndexes.Add(RevisionIndex);
 	}
-	for (auto& Revision : OutHistory)
+	if (MergeObjectNames.Num() > 0)
 	{
-		// Get file (blob) sha1 id and size
-		TArray<FString> Results;
-		TArray<FString> Parameters;
-		Parameters.Add(TEXT("--long")); // Show object size of blob (file) entries.
-		Parameters.Add(Revision->GetRevision());
-		TArray<FString> Files;
-		Files.Add(*Revision->GetFilename());
-		bResults &= RunCommand(TEXT("ls-tree"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, OutErrorMessages);
-		if (bResults && Results.Num())
+		TArray<FGitObjectInfo> MergeInfos;
+		if (FGitCatFilePool::Get().GetObjectInfos(InPathToGitBinary, InRepositoryRoot, MergeObjectNames, MergeInfos) && (MergeInfos.Num() == MergeObjectNames.Num()))
 		{
-			FGitLsTreeParser LsTree(Results);
-			Revision->FileHash = LsTree.FileHash;
-			Revision->FileSize = LsTree.FileSize;
+			for (int32 MergeIndex = 0; MergeIndex < MergeInfos.Num(); MergeIndex++)
+			{
+				const FGitObjectInfo& MergeInfo = MergeInfos[MergeIndex];
+				if (MergeInfo.IsValid())
+				{
+					OutHistory[MergeRevisionIndexes[MergeIndex]]->FileHash = MergeInfo.Hash;
+				}
+			}
 		}
+	}
+
+	// Get the size of all the file (blob) revisions in one round-trip to the persistent "cat-file --batch-check" process
+	TArray<FString> BlobIds;
+	BlobIds.Reserve(OutHistory.Num());
+	for (const auto& Revision : OutHistory)
+	{
 		Revision->PathToRepoRoot = InRepositoryRoot;
+		if (!Revision->FileHash.IsEmpty())
+		{
+			BlobIds.Add(Revision->FileHash);
+		}
+	}
+	if (BlobIds.Num() == 0)
+	{
+		return bResults;
+	}
+
+	TArray<FGitObjectInfo> BlobInfos;
+	if (FGitCatFilePool::Get().GetObjectInfos(InPathToGitBinary, InRepositoryRoot, BlobIds, BlobInfos) && (BlobInfos.Num() == BlobIds.Num()))
+	{
+		int32 BlobIndex = 0;
+		for (const auto& Revision : OutHistory)
+		{
+			if (!Revision->FileHash.IsEmpty())
+			{
+				const FGitObjectInfo& BlobInfo = BlobInfos[BlobIndex++];
+				if (BlobInfo.IsValid())
+				{
+					Revision->FileSize = static_cast<int32>(BlobInfo.Size);
+				}
+			}
+		}
+	}
+	else
+	{
+		// Fallback: one "cat-file -s" per blob
+		for (const auto& Revision : OutHistory)
+		{
+			if (!Revision->FileHash.IsEmpty())
+			{
+				TArray<FString> Results;
+				TArray<FString> Parameters;
+				Parameters.Add(TEXT("-s")); // Show object size
+				Parameters.Add(Revision->FileHash);
+				bResults &= RunCommand(TEXT("cat-file"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), Results, OutErrorMessages);
+				if (bResults && Results.Num())
+				{
+					Revision->FileSize = FCString::Atoi(*Results[0]);
+				}
+			}
+		}
 	}
 
 	return bResults;
@@ -2164,38 +3581,103 @@ TArray<FString> AbsoluteFilenames(const TArray<FString>& InFileNames, const FStr
 
 bool UpdateCachedStates(const TMap<const FString, FGitState>& InResults)
 {
+	FGitCachedStatesUpdate Update;
+	if (!PrepareCachedStates(InResults, Update))
+	{
+		return false;
+	}
+	return UpdateCachedStates(Update);
+}
+
+/** Tells if applying a new state to a state of the cache would change it (see ApplyCachedState()) */
+static bool IsCachedStateChanged(const FGitState& InCachedState, const FGitState& InNewState)
+{
+	if ((InNewState.FileState != EFileState::Unset) && (InNewState.FileState != InCachedState.FileState))
+	{
+		return true;
+	}
+	if ((InNewState.TreeState != ETreeState::Unset) && (InNewState.TreeState != InCachedState.TreeState))
+	{
+		return true;
+	}
+	if ((InNewState.LockState != ELockState::Unset) && ((InNewState.LockState != InCachedState.LockState) || !InNewState.LockUser.Equals(InCachedState.LockUser, ESearchCase::CaseSensitive)))
+	{
+		return true;
+	}
+	if (InNewState.RemoteState != ERemoteState::Unset)
+	{
+		const FString& HeadBranch = (InNewState.RemoteState == ERemoteState::UpToDate) ? FString() : InNewState.HeadBranch;
+		return (InNewState.RemoteState != InCachedState.RemoteState) || !HeadBranch.Equals(InCachedState.HeadBranch, ESearchCase::CaseSensitive);
+	}
+	return false;
+}
+
+bool PrepareCachedStates(const TMap<const FString, FGitState>& InResults, FGitCachedStatesUpdate& OutUpdate)
+{
+	OutUpdate = FGitCachedStatesUpdate();
 	if (InResults.Num() == 0)
 	{
 		return false;
 	}
-	
+
 	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
 	if (!GitSourceControl)
 	{
 		return false;
 	}
 	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
-	const bool bUsingGitLfsLocking = Provider.UsesCheckout();
 
-	// TODO without LFS : Workaround a bug with the Source Control Module not updating file state after a simple "Save" with no "Checkout" (when not using File Lock)
-	const FDateTime Now = bUsingGitLfsLocking ? FDateTime::Now() : FDateTime::MinValue();
+	// Read the generation before comparing: if the main thread changes the cache in the meantime, UpdateCachedStates() applies all the states
+	OutUpdate.Generation = Provider.GetStateCacheGeneration();
 
+	TArray<TPair<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>, FGitState>> UnchangedStates;
+	OutUpdate.States.Reserve(InResults.Num());
 	for (const auto& Pair : InResults)
 	{
 		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(Pair.Key);
-		const FGitState& NewState = Pair.Value;
+		bool bChanged;
+		{
+			// The status fields of the states are only written by the main thread under the write lock
+			FRWScopeLock Lock(Provider.GetStateLock(Pair.Key), SLT_ReadOnly);
+			bChanged = IsCachedStateChanged(State->State, Pair.Value);
+		}
+		if (bChanged)
+		{
+			OutUpdate.States.Emplace(MoveTemp(State), Pair.Value);
+		}
+		else
+		{
+			UnchangedStates.Emplace(MoveTemp(State), Pair.Value);
+		}
+	}
+	OutUpdate.NumChanged = OutUpdate.States.Num();
+	OutUpdate.States.Append(MoveTemp(UnchangedStates));
+
+	return true;
+}
+
+/**
+ * Apply a new state to a state of the cache (main thread)
+ * @returns false for an invalid transition, ignored
+ */
+static bool ApplyCachedState(FGitSourceControlProvider& Provider, const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State, const FGitState& NewState)
+{
+	bool bTreeStateChanged = false;
+	{
+		FRWScopeLock Lock(Provider.GetStateLock(State->LocalFilename), SLT_Write);
 		if (NewState.FileState != EFileState::Unset)
 		{
 			// Invalid transition
 			if (NewState.FileState == EFileState::Added && !State->IsUnknown() && !State->CanAdd())
 			{
-				continue;
+				return false;
 			}
 			State->State.FileState = NewState.FileState;
 		}
 		if (NewState.TreeState != ETreeState::Unset)
 		{
 			State->State.TreeState = NewState.TreeState;
+			bTreeStateChanged = true;
 		}
 		// If we're updating lock state, also update user
 		if (NewState.LockState != ELockState::Unset)
@@ -2208,20 +3690,63 @@ bool UpdateCachedStates(const TMap<const FString, FGitState>& InResults)
 			State->State.RemoteState = NewState.RemoteState;
 			if (NewState.RemoteState == ERemoteState::UpToDate)
 			{
-				State->State.HeadBranch = TEXT("");
+				State->State.HeadBranch.Empty();
 			}
 			else
 			{
 				State->State.HeadBranch = NewState.HeadBranch;
 			}
 		}
+	}
+	if (bTreeStateChanged)
+	{
+		// Keep the Staged and Working changelists up to date with the new status of the file
+		MoveStateToChangelist(Provider, State, GetChangelistOfState(State->State));
+	}
+	Provider.UpdateStateCategories(State);
+	return true;
+}
+
+bool UpdateCachedStates(const FGitCachedStatesUpdate& InUpdate)
+{
+	if (InUpdate.States.Num() == 0)
+	{
+		return false;
+	}
+
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl)
+	{
+		return false;
+	}
+	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
+	const bool bUsingGitLfsLocking = Provider.UsesCheckout();
+
+	// TODO without LFS : Workaround a bug with the Source Control Module not updating file state after a simple "Save" with no "Checkout" (when not using File Lock)
+	const FDateTime Now = bUsingGitLfsLocking ? FDateTime::Now() : FDateTime::MinValue();
+
+	// Only the states that changed need to be applied, unless the cache changed since they were compared to it
+	const bool bCacheChanged = (InUpdate.Generation != Provider.GetStateCacheGeneration());
+	const int32 NumToApply = bCacheChanged ? InUpdate.States.Num() : InUpdate.NumChanged;
+	for (int32 Index = 0; Index < InUpdate.States.Num(); Index++)
+	{
+		// A state removed from the cache in the meantime is added back
+		const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = bCacheChanged ? Provider.GetStateInternal(InUpdate.States[Index].Key->LocalFilename) : InUpdate.States[Index].Key;
+		if (Index < NumToApply && !ApplyCachedState(Provider, State, InUpdate.States[Index].Value))
+		{
+			continue;
+		}
 		State->TimeStamp = Now;
 
 		// We've just updated the state, no need for UpdateStatus to be ran for this file again.
-		Provider.AddFileToIgnoreForceCache(State->LocalFilename);
+		State->bIgnoreForceUpdate = true;
+	}
+	if (NumToApply > 0)
+	{
+		Provider.IncrementStateCacheGeneration();
 	}
 
-	return true;
+	return NumToApply > 0;
 }
 
 bool CollectNewStates(const TMap<FString, FGitSourceControlState>& InStates, TMap<const FString, FGitState>& OutResults)
@@ -2406,7 +3931,8 @@ bool PullOrigin(const FString& InPathToGitBinary, const FString& InPathToReposit
 
 	// Get the list of files which will be updated (either ones we changed locally, which will get potentially rebased or merged, or the remote ones that will update)
 	TArray<FString> DifferentFiles;
-	const bool bResultDiff = RunCommand(TEXT("diff"), InPathToGitBinary, InPathToRepositoryRoot, { TEXT("--name-only"), RemoteBranch }, FGitSourceControlModule::GetEmptyStringArray(), DifferentFiles, OutErrorMessages);
+	const bool bResultDiff = RunCommandStreaming(TEXT("diff"), InPathToGitBinary, InPathToRepositoryRoot, { TEXT("--name-only"), TEXT("-z"), RemoteBranch }, FGitSourceControlModule::GetEmptyStringArray(),
+		[&DifferentFiles](FStringView RelativeFilename) { DifferentFiles.Emplace(RelativeFilename); }, OutErrorMessages, '\0');
 	if (!bResultDiff)
 	{
 		return false;
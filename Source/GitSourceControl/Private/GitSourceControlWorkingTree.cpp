@@ -0,0 +1,233 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlWorkingTree.h"
+
+#include "GitSourceControlRefs.h"
+#include "ISourceControlModule.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Modules/ModuleManager.h"
+
+namespace GitSourceControlConstants
+{
+/** Above this number of changed paths, a full status is faster than giving them all to git status */
+const int32 MaxDirtyPaths = 1000;
+
+/** Maximum time between two full statuses of the project directories (in seconds), in case a notification of the file system was missed */
+const double MaxIncrementalStatusAge = 300.0;
+} // namespace GitSourceControlConstants
+
+/** Remove the trailing slash of a directory */
+static FString WithoutTrailingSlash(const FString& InPath)
+{
+	FString Path = InPath;
+	FPaths::NormalizeFilename(Path);
+	Path.RemoveFromEnd(TEXT("/"));
+	return Path;
+}
+
+FGitWorkingTreeWatcher& FGitWorkingTreeWatcher::Get()
+{
+	static FGitWorkingTreeWatcher Instance;
+	return Instance;
+}
+
+void FGitWorkingTreeWatcher::Start(const FString& InRepositoryRoot)
+{
+	Stop();
+
+	FScopeLock Lock(&CriticalSection);
+
+	const FGitRefsReader Refs(InRepositoryRoot);
+	if (!Refs.IsValid())
+	{
+		return;
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (!DirectoryWatcher)
+	{
+		return;
+	}
+
+	const TArray<FString> ProjectDirs{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),
+									  FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
+									  FPaths::ConvertRelativePathToFull(FPaths::ProjectPluginsDir())};
+	for (const FString& ProjectDir : ProjectDirs)
+	{
+		const FString Directory = WithoutTrailingSlash(ProjectDir);
+		if (!IFileManager::Get().DirectoryExists(*Directory))
+		{
+			continue;
+		}
+		FDelegateHandle Handle;
+		// Also report the directories, since deleting or renaming one does not always report the files it contained
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Directory, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FGitWorkingTreeWatcher::OnDirectoryChanged), Handle, IDirectoryWatcher::WatchOptions::IncludeDirectoryChanges))
+		{
+			WatchedDirectories.Emplace(Directory, Handle);
+		}
+		else
+		{
+			UE_LOG(LogSourceControl, Warning, TEXT("Failed to watch '%s' for changes of the working tree"), *Directory);
+		}
+	}
+
+	RepositoryRoot = WithoutTrailingSlash(InRepositoryRoot);
+	GitDirectory = Refs.GetGitDirectory();
+}
+
+void FGitWorkingTreeWatcher::Stop()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (WatchedDirectories.Num() > 0)
+	{
+		if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+		{
+			if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+			{
+				for (const TPair<FString, FDelegateHandle>& WatchedDirectory : WatchedDirectories)
+				{
+					DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory.Key, WatchedDirectory.Value);
+				}
+			}
+		}
+		WatchedDirectories.Empty();
+	}
+
+	RepositoryRoot.Empty();
+	GitDirectory.Empty();
+	DirtyPaths.Empty();
+	bTooManyDirtyPaths = false;
+	bHasBaseline = false;
+}
+
+void FGitWorkingTreeWatcher::Invalidate()
+{
+	FScopeLock Lock(&CriticalSection);
+	bHasBaseline = false;
+}
+
+FGitWorkingTreeBaseline FGitWorkingTreeWatcher::ReadBaseline() const
+{
+	FGitWorkingTreeBaseline Current;
+	Current.RefsGeneration = FGitRefsWatcher::Get().GetGeneration();
+	const FFileStatData IndexStatData = IFileManager::Get().GetStatData(*(GitDirectory / TEXT("index")));
+	if (IndexStatData.bIsValid)
+	{
+		Current.IndexFileSize = IndexStatData.FileSize;
+		Current.IndexFileTime = IndexStatData.ModificationTime;
+	}
+	Current.Time = FPlatformTime::Seconds();
+	return Current;
+}
+
+bool FGitWorkingTreeWatcher::BeginStatus(const FString& InRepositoryRoot, const TArray<FString>& InProjectPaths, TArray<FString>& OutPaths, FGitWorkingTreeBaseline& OutBaseline)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (WatchedDirectories.Num() == 0 || !RepositoryRoot.Equals(WithoutTrailingSlash(InRepositoryRoot)))
+	{
+		// Not watched: EndStatus() will ignore this status
+		OutPaths = InProjectPaths;
+		OutBaseline = FGitWorkingTreeBaseline();
+		return false;
+	}
+
+	const FGitWorkingTreeBaseline Current = ReadBaseline();
+	const bool bIncremental = bHasBaseline && !bTooManyDirtyPaths
+		&& (Current.RefsGeneration == Baseline.RefsGeneration)
+		&& (Current.IndexFileSize == Baseline.IndexFileSize) && (Current.IndexFileTime == Baseline.IndexFileTime)
+		&& (Current.Time - Baseline.Time < GitSourceControlConstants::MaxIncrementalStatusAge);
+
+	// Take the changed paths: the ones changed from now on are for the next status
+	TSet<FString> ChangedPaths = MoveTemp(DirtyPaths);
+	DirtyPaths.Reset();
+	bTooManyDirtyPaths = false;
+
+	if (!bIncremental)
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("Full status of the project directories"));
+		OutPaths = InProjectPaths;
+		OutBaseline = Current;
+		bHasBaseline = false;
+		return false;
+	}
+
+	OutBaseline = Baseline;
+	for (const FString& ProjectPath : InProjectPaths)
+	{
+		const FString Path = WithoutTrailingSlash(ProjectPath);
+		const bool bWatched = WatchedDirectories.ContainsByPredicate([&Path](const TPair<FString, FDelegateHandle>& InWatchedDirectory)
+		{
+			return Path.Equals(InWatchedDirectory.Key) || Path.StartsWith(InWatchedDirectory.Key + TEXT("/"));
+		});
+		if (!bWatched)
+		{
+			// Files like the project descriptor are always checked (the index filters them out if unchanged)
+			OutPaths.Add(ProjectPath);
+			continue;
+		}
+		const FString PathPrefix = Path + TEXT("/");
+		for (const FString& ChangedPath : ChangedPaths)
+		{
+			if (ChangedPath.Equals(Path) || ChangedPath.StartsWith(PathPrefix))
+			{
+				OutPaths.Add(ChangedPath);
+			}
+		}
+	}
+
+	UE_LOG(LogSourceControl, Verbose, TEXT("Incremental status of the project directories: %d paths changed"), OutPaths.Num());
+
+	return true;
+}
+
+void FGitWorkingTreeWatcher::EndStatus(const bool bInSuccess, const bool bInFullStatus, const TArray<FString>& InPaths, const FGitWorkingTreeBaseline& InBaseline)
+{
+	if (InBaseline.RefsGeneration == INDEX_NONE)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	if (bInFullStatus)
+	{
+		if (bInSuccess)
+		{
+			Baseline = InBaseline;
+			bHasBaseline = true;
+		}
+	}
+	else if (!bInSuccess)
+	{
+		// Check them again next time
+		DirtyPaths.Append(InPaths);
+	}
+}
+
+void FGitWorkingTreeWatcher::OnDirectoryChanged(const TArray<FFileChangeData>& InFileChanges)
+{
+	FScopeLock Lock(&CriticalSection);
+	if (bTooManyDirtyPaths)
+	{
+		return;
+	}
+	for (const FFileChangeData& FileChange : InFileChanges)
+	{
+		DirtyPaths.Add(WithoutTrailingSlash(FileChange.Filename));
+	}
+	if (DirtyPaths.Num() > GitSourceControlConstants::MaxDirtyPaths)
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("More than %d paths changed in the working tree"), GitSourceControlConstants::MaxDirtyPaths);
+		DirtyPaths.Empty();
+		bTooManyDirtyPaths = true;
+	}
+}
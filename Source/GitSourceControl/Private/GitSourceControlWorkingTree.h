@@ -0,0 +1,94 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * State of the repository when a status of the project directories started, to tell if the next one can be incremental
+ */
+struct FGitWorkingTreeBaseline
+{
+	/** Generation of the references (see FGitRefsWatcher) */
+	int32 RefsGeneration = INDEX_NONE;
+
+	/** Size and modification time of the index file */
+	int64 IndexFileSize = -1;
+	FDateTime IndexFileTime;
+
+	/** When the status started */
+	double Time = 0.0;
+};
+
+/**
+ * Watch the project directories of the working tree (Content/, Config/ and Plugins/) and collect the paths changed since the last status,
+ * so that a status of the whole project only has to ask Git about them: the states of all the other files in the cache are still valid.
+ *
+ * A full status is still required when nothing is known yet, when the references or the index changed (commit, checkout, git add...),
+ * when too many paths changed, and after a while as a safety net against missed notifications.
+ */
+class FGitWorkingTreeWatcher
+{
+public:
+	static FGitWorkingTreeWatcher& Get();
+
+	/** Start watching the project directories in a repository (game thread) */
+	void Start(const FString& InRepositoryRoot);
+
+	/** Stop watching (game thread) */
+	void Stop();
+
+	/** Require a full status the next time (thread-safe) */
+	void Invalidate();
+
+	/**
+	 * Get the paths to give to git status for a status of the project directories, and take the changed paths (thread-safe)
+	 * @param	InRepositoryRoot	The root of the repository of the status
+	 * @param	InProjectPaths		The project directories and files of a full status
+	 * @param	OutPaths			The changed paths in the watched directories, and the paths that are not watched
+	 * @param	OutBaseline			The state of the repository to give to EndStatus()
+	 * @returns false if a full status of InProjectPaths is required
+	 */
+	bool BeginStatus(const FString& InRepositoryRoot, const TArray<FString>& InProjectPaths, TArray<FString>& OutPaths, FGitWorkingTreeBaseline& OutBaseline);
+
+	/**
+	 * Tell that a status started with BeginStatus() is finished (thread-safe)
+	 * @param	bInSuccess		If the status succeeded: the next one can then be incremental
+	 * @param	bInFullStatus	If it was a full status (BeginStatus() returned false)
+	 * @param	InPaths			The changed paths taken by BeginStatus(), to check again after a failure
+	 */
+	void EndStatus(const bool bInSuccess, const bool bInFullStatus, const TArray<FString>& InPaths, const FGitWorkingTreeBaseline& InBaseline);
+
+private:
+	/** Called by the directory watcher on the game thread */
+	void OnDirectoryChanged(const TArray<struct FFileChangeData>& InFileChanges);
+
+	/** Read the current state of the repository */
+	FGitWorkingTreeBaseline ReadBaseline() const;
+
+	/** Critical section for thread safety of the fields below */
+	FCriticalSection CriticalSection;
+
+	/** Directories being watched, with the handles of their callbacks */
+	TArray<TPair<FString, FDelegateHandle>> WatchedDirectories;
+
+	/** Root of the repository, and its Git directory holding the index */
+	FString RepositoryRoot;
+	FString GitDirectory;
+
+	/** Paths (files and directories) changed since the last status */
+	TSet<FString> DirtyPaths;
+
+	/** True if more paths changed than worth giving to git status */
+	bool bTooManyDirtyPaths = false;
+
+	/** True if the last full status succeeded, and nothing invalidated it since */
+	bool bHasBaseline = false;
+
+	/** State of the repository when the last successful full status started */
+	FGitWorkingTreeBaseline Baseline;
+};
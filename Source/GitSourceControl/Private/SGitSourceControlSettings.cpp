@@ -27,6 +27,8 @@
 #include "SourceControlOperations.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlUtils.h"
+#include "GitSourceControlWorkingTree.h"
+#include "Async/Async.h"
 
 
 #define LOCTEXT_NAMESPACE "SGitSourceControlSettings"
@@ -332,6 +334,38 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 				.Font(Font)
 				]
 				]
+			// Option to accelerate "git status" with the file system monitor and the untracked cache (false by default)
+			+SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SHorizontalBox)
+					.ToolTipText(LOCTEXT("UseStatusAcceleration_Tooltip", "Uses the file system monitor (fsmonitor daemon, or a fsmonitor-watchman hook on Linux) and the untracked cache of Git when the repository does not configure them."))
+				+ SHorizontalBox::Slot()
+				.FillWidth(0.1f)
+				[
+					SNew(SCheckBox)
+					.IsChecked(this, &SGitSourceControlSettings::IsUsingStatusAcceleration)
+				.OnCheckStateChanged(this, &SGitSourceControlSettings::OnCheckedUseStatusAcceleration)
+				]
+			+ SHorizontalBox::Slot()
+				.FillWidth(0.9f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UseStatusAcceleration", "Accelerate status"))
+				.Font(Font)
+				]
+			+ SHorizontalBox::Slot()
+				.FillWidth(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(this, &SGitSourceControlSettings::GetStatusAccelerationText)
+				.Font(Font)
+				]
+				]
 			// Option to Make the initial Git commit with custom message
 			+ SVerticalBox::Slot()
 				.AutoHeight()
@@ -419,6 +453,7 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 	#define TT_UserName LOCTEXT("UserNameLabel_Tooltip", "Git Username fetched from local config")
 	#define TT_Email LOCTEXT("GitUserEmail_Tooltip", "Git E-mail fetched from local config")
 	#define TT_LFS LOCTEXT("UseGitLfsLocking_Tooltip", "Uses Git LFS 2 File Locking workflow (CheckOut and Commit/Push).")
+	#define TT_StatusAcceleration LOCTEXT("UseStatusAcceleration_Tooltip", "Uses the file system monitor (fsmonitor daemon, or a fsmonitor-watchman hook on Linux) and the untracked cache of Git when the repository does not configure them.")
 
 	ChildSlot
 	[
@@ -529,6 +564,30 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 				.HintText(LOCTEXT("LfsUserName_Hint", "Username to lock files on the LFS server"))
 			]
 		]
+		// Status acceleration
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(SHorizontalBox)
+			ROW_LEFT( 10.0f )
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &Self::IsUsingStatusAcceleration)
+				.OnCheckStateChanged(this, &Self::OnCheckedUseStatusAcceleration)
+				.Content()
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UseStatusAcceleration", "Accelerate status"))
+					.ToolTipText( TT_StatusAcceleration )
+				]
+			]
+			ROW_RIGHT( 10.0f )
+			[
+				SNew(STextBlock)
+				.Text(this, &Self::GetStatusAccelerationText)
+				.ToolTipText( TT_StatusAcceleration )
+			]
+		]
 		// [Optional] Initial Git Commit
 		+SVerticalBox::Slot()
 		.AutoHeight()
@@ -917,6 +976,41 @@ ECheckBoxState SGitSourceControlSettings::IsUsingGitLfsLocking() const
 	return (GetIsUsingGitLfsLocking() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked);
 }
 
+void SGitSourceControlSettings::OnCheckedUseStatusAcceleration(ECheckBoxState NewCheckedState)
+{
+	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	GitSourceControl.AccessSettings().SetUsingStatusAcceleration(NewCheckedState == ECheckBoxState::Checked);
+	GitSourceControl.AccessSettings().SaveSettings();
+
+	// Apply it in the background, then measure a full status of the project with the new setting
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, []()
+	{
+		FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+		GitSourceControl.GetProvider().UpdateStatusAcceleration();
+		AsyncTask(ENamedThreads::GameThread, []()
+		{
+			FGitWorkingTreeWatcher::Get().Invalidate();
+			FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+			if (GitSourceControl.GetProvider().IsEnabled())
+			{
+				GitSourceControl.GetProvider().Execute(ISourceControlOperation::Create<FUpdateStatus>(), TArray<FString>(), EConcurrency::Asynchronous);
+			}
+		});
+	});
+}
+
+ECheckBoxState SGitSourceControlSettings::IsUsingStatusAcceleration() const
+{
+	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	return (GitSourceControl.AccessSettings().IsUsingStatusAcceleration() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked);
+}
+
+FText SGitSourceControlSettings::GetStatusAccelerationText() const
+{
+	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	return GitSourceControl.GetProvider().GetStatusAccelerationText();
+}
+
 void SGitSourceControlSettings::OnLfsUserNameCommited(const FText& InText, ETextCommit::Type InCommitType)
 {
 	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
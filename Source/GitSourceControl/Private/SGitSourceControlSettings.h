@@ -70,6 +70,11 @@ private:
 	ECheckBoxState IsUsingGitLfsLocking() const;
 	bool GetIsUsingGitLfsLocking() const;
 
+	/** Delegates to enable the acceleration of "git status", and to show its measured effect */
+	void OnCheckedUseStatusAcceleration(ECheckBoxState NewCheckedState);
+	ECheckBoxState IsUsingStatusAcceleration() const;
+	FText GetStatusAccelerationText() const;
+
 	void OnLfsUserNameCommited(const FText& InText, ETextCommit::Type InCommitType);
 	FText GetLfsUserName() const;
 
@@ -6,7 +6,9 @@
 #pragma once
 
 #include "GitSourceControlChangelist.h"
+#include "IGitSourceControlWorker.h"
 #include "ISourceControlProvider.h"
+#include "HAL/CriticalSection.h"
 #include "Misc/IQueuedWork.h"
 
 /** Accumulated error and info messages for a revision control operation.  */
@@ -36,6 +38,8 @@ public:
 
 	FGitSourceControlCommand(const TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>& InOperation, const TSharedRef<class IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const FSourceControlOperationComplete& InOperationCompleteDelegate = FSourceControlOperationComplete());
 
+	virtual ~FGitSourceControlCommand();
+
 	/**
 	 *  Modify the repo root if all selected files are in a plugin subfolder, and the plugin subfolder is a git repo
 	 *  This supports the case where each plugin is a sub module
@@ -71,6 +75,18 @@ public:
 	/** Save any results and call any registered callbacks. */
 	ECommandResult::Type ReturnResults();
 
+	/**
+	 * Merge other operations into this command to share its results, but only if it has not started yet (main thread)
+	 * @returns false if the command already started, leaving InOutOperations untouched
+	 */
+	bool AppendCoalescedOperationsIfNotStarted(TArray<TPair<TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>, FSourceControlOperationComplete>>& InOutOperations);
+
+	/** Tells if the command has started; a command not started yet can start as soon as this returns, unless the caller holds the StartCriticalSection */
+	bool IsStarted() const
+	{
+		return bExecuteStarted != 0;
+	}
+
 public:
 	/** Path to the Git binary */
 	FString PathToGitBinary;
@@ -93,12 +109,27 @@ public:
 	/** Delegate to notify when this operation completes */
 	FSourceControlOperationComplete OperationCompleteDelegate;
 
+	/** Other operations merged into this command (see FGitSourceControlProvider::IssuePendingUpdateStatuses()): they share its results */
+	TArray<TPair<TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>, FSourceControlOperationComplete>> CoalescedOperations;
+
+	/** Unique id given by the provider when the command is issued: unlike its address, never reused by another command once this one is deleted */
+	uint32 CommandId;
+
+	/** Taken by the worker thread to flag the command as started, and by the provider to rely on a command that has not started yet */
+	FCriticalSection StartCriticalSection;
+
+	/**If true, this command has been started by the revision control thread*/
+	volatile int32 bExecuteStarted;
+
 	/**If true, this command has been processed by the revision control thread*/
 	volatile int32 bExecuteProcessed;
 
 	/**If true, this command has been cancelled*/
 	volatile int32 bCancelled;
 
+	/** Triggered when the command has been processed by the revision control thread, or cancelled, to wake up a synchronous wait */
+	FEvent* CompletionEvent;
+
 	/**If true, the revision control command succeeded*/
 	bool bCommandSuccessful;
 
@@ -114,6 +145,9 @@ public:
 	/** Whether we are running multi-treaded or not*/
 	EConcurrency::Type Concurrency;
 
+	/** Scheduling priority of the command in the executor (see FGitSourceControlProvider::RegisterWorker()) */
+	EGitCommandPriority::Type Priority;
+
 	/** Files to perform this operation on */
 	TArray<FString> Files;
 
@@ -7,7 +7,10 @@
 
 #include "GitSourceControlChangelist.h"
 #include "GitSourceControlMenu.h"
+#include "GitSourceControlState.h"
 
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Misc/EngineVersionComparison.h"
 #include "ISourceControlProvider.h"
 #include "IGitSourceControlWorker.h"
@@ -18,6 +21,32 @@ class FGitSourceControlState;
 
 class FGitSourceControlCommand;
 
+/**
+ * Key functions of the state cache: each state is keyed by its own LocalFilename, so that each path is stored only once,
+ * and is found from a string view without any allocation (case-insensitive, like the paths of the Editor)
+ */
+struct FGitStateCacheKeyFuncs : BaseKeyFuncs<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>, FStringView, false>
+{
+	static FStringView GetSetKey(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState);
+	static bool Matches(FStringView A, FStringView B);
+	static uint32 GetKeyHash(FStringView InKey);
+};
+
+/** Number of shards of the state cache, selected by the top bits of the hash of the filenames */
+static constexpr uint32 GitStateCacheShardBits = 4;
+static constexpr uint32 GitStateCacheShardCount = 1 << GitStateCacheShardBits;
+
+/**
+ * A shard of the state cache, with its own reader-writer lock, so that worker threads can find and add states while the main thread reads others.
+ * The status fields of the states (FGitState) are only written by the main thread while holding the write lock of their shard,
+ * so that worker threads can compare them to their results while holding the read lock.
+ */
+struct FGitStateCacheShard
+{
+	mutable FRWLock Lock;
+	TSet<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>, FGitStateCacheKeyFuncs> States;
+};
+
 DECLARE_DELEGATE_RetVal(FGitSourceControlWorkerRef, FGetGitSourceControlWorker)
 
 /// Git version and capabilites extracted from the string "git version 2.11.0.windows.3"
@@ -33,6 +62,12 @@ struct FGitVersion
 	int ForkMinor; // 3 
 	int ForkPatch; // ?
 
+	// Optional capabilities (see GitSourceControlUtils::FindGitCapabilities())
+	bool bHasPathspecFromFile; // "--pathspec-from-file" and "--pathspec-file-nul" options of add/commit/reset/restore/checkout/rm (Git 2.26)
+	bool bHasStatusPorcelainV2; // "git status --porcelain=v2", with the "--branch" headers (Git 2.11)
+	bool bHasUntrackedCache; // "core.untrackedCache" config, to avoid scanning all directories for untracked files (Git 2.8)
+	bool bHasFsMonitorDaemon; // builtin file system monitor daemon "core.fsmonitor=true" (Git 2.36, Windows and macOS only)
+
 	FGitVersion() 
 		: Major(0)
 		, Minor(0)
@@ -41,10 +76,32 @@ struct FGitVersion
 		, ForkMajor(0)
 		, ForkMinor(0)
 		, ForkPatch(0)
+		, bHasPathspecFromFile(false)
+		, bHasStatusPorcelainV2(false)
+		, bHasUntrackedCache(false)
+		, bHasFsMonitorDaemon(false)
+	{
+	}
+
+	inline bool IsGreaterOrEqualThan(int InMajor, int InMinor) const
 	{
+		return (Major > InMajor) || (Major == InMajor && Minor >= InMinor);
 	}
 };
 
+/** Position of the current branch relative to its upstream, from the "--branch" headers of "git status --porcelain=v2" */
+struct FGitBranchStatus
+{
+	/** Upstream of the current branch ("origin/main"), empty if none */
+	FString Upstream;
+
+	/** Number of commits of the current branch missing in its upstream (INDEX_NONE if unknown) */
+	int32 Ahead = INDEX_NONE;
+
+	/** Number of commits of the upstream missing in the current branch (INDEX_NONE if unknown) */
+	int32 Behind = INDEX_NONE;
+};
+
 class GITSOURCECONTROL_API FGitSourceControlProvider final : public ISourceControlProvider
 {
 public:
@@ -117,6 +174,21 @@ public:
 	 */
 	void CheckRepositoryStatus();
 
+	/** Detect how "git status" can be accelerated in the repository, and use it if enabled in the settings (blocking: runs Git commands) */
+	void UpdateStatusAcceleration();
+
+	/** Global options given to all Git commands to accelerate "git status" ("-c core.fsmonitor=true -c core.untrackedCache=true "), empty if disabled (thread-safe) */
+	FString GetStatusAccelerationOptions() const;
+
+	/** Record the duration of a full status of the project directories (thread-safe) */
+	void RecordFullStatusTime(const bool bInAccelerated, const double InSeconds);
+
+	/** Describe the acceleration available in the repository, and the average duration of a full status with and without it, for the settings */
+	FText GetStatusAccelerationText() const;
+
+	/** Keep the position of the current branch relative to its upstream, as told by the last status of the project (thread-safe) */
+	void SetBranchStatus(const FGitBranchStatus& InBranchStatus);
+
 	/** Is git binary found and working. */
 	inline bool IsGitAvailable() const
 	{
@@ -170,8 +242,47 @@ public:
 		return LockUser;
 	}
 
-	/** Helper function used to update state cache */
-	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> GetStateInternal(const FString& Filename);
+	/** Helper function used to update state cache (the filename must be absolute and normalized). Thread-safe. */
+	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> GetStateInternal(FStringView Filename);
+
+	/** Find a state in the cache, without adding it if missing. Thread-safe. */
+	TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> FindStateInternal(FStringView Filename) const;
+
+	/** Lock of the shard of the state cache holding a file, to read (worker threads) or write (main thread) its status fields */
+	FRWLock& GetStateLock(FStringView Filename) const
+	{
+		return GetStateCacheShard(FGitStateCacheKeyFuncs::GetKeyHash(Filename)).Lock;
+	}
+
+	/**
+	 * Generation of the state cache, incremented by the main thread each time it changes the states of the cache. Thread-safe.
+	 * Results compared to the cache by a worker thread are still valid if the generation did not change since then.
+	 */
+	int32 GetStateCacheGeneration() const
+	{
+		return StateCacheGeneration.GetValue();
+	}
+
+	/** Tell that the states of the cache changed (main thread) */
+	void IncrementStateCacheGeneration()
+	{
+		StateCacheGeneration.Increment();
+	}
+
+	/** Change the filename of a state of the cache */
+	void RenameStateInternal(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState, const FString& InNewFilename);
+
+	/** Update the category indices of a state of the cache, after a change of its status */
+	void UpdateStateCategories(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState);
+
+	/**
+	 * Get the cached states in some categories, in O(result) instead of scanning the whole cache like GetCachedStateByPredicate()
+	 * @param	InCategories	Mask of the categories (see EGitStateCategory::Bit())
+	 */
+	TArray<FSourceControlStateRef> GetCachedStatesByCategory(const uint32 InCategories) const;
+
+	/** Get the cached states in some categories that also match a predicate */
+	TArray<FSourceControlStateRef> GetCachedStatesByCategory(const uint32 InCategories, TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const;
 
 	/** Helper function used to update changelists state cache */
 	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> GetStateInternal(const FGitSourceControlChangelist& InChangelist);
@@ -179,8 +290,12 @@ public:
 	/**
 	 * Register a worker with the provider.
 	 * This is used internally so the provider can maintain a map of all available operations.
+	 * @param	InPriority	Default scheduling priority of the commands of this operation
 	 */
-	void RegisterWorker( const FName& InName, const FGetGitSourceControlWorker& InDelegate );
+	void RegisterWorker( const FName& InName, const FGetGitSourceControlWorker& InDelegate, const EGitCommandPriority::Type InPriority = EGitCommandPriority::Foreground );
+
+	/** Default scheduling priority of the commands of an operation */
+	EGitCommandPriority::Type GetWorkerPriority(const FName& InOperationName) const;
 
 	/** Set list of error messages that occurred after last perforce command */
 	void SetLastErrors(const TArray<FText>& InErrors);
@@ -197,17 +312,24 @@ public:
 	/** Get files in cache */
 	TArray<FString> GetFilesInCache();
 
+	/** Log the memory used by the state cache, in total and per file */
+	void LogStateCacheMemoryReport() const;
+
+	/**
+		Ignore these files when forcing status updates. We flag them when we've just updated the status already.
+		UE's SourceControl has a habit of performing a double status update, immediately after an operation.
+	*/
 	bool AddFileToIgnoreForceCache(const FString& Filename);
 
 	bool RemoveFileFromIgnoreForceCache(const FString& Filename);
 
-	const FString& GetBranchName() const
-	{
-		return BranchName;
-	}
+	/** Name of the current branch (cached until the references of the repository change) */
+	FString GetBranchName() const;
 
-	const FString& GetRemoteBranchName() const { return RemoteBranchName; }
+	/** Name of the upstream of the current branch, like "origin/main" (cached until the references of the repository change) */
+	FString GetRemoteBranchName() const;
 
+	/** Remote branches matching the status branch patterns (cached until the references of the repository change) */
 	TArray<FString> GetStatusBranchNames() const;
 	
 	/** Indicates editor binaries are to be updated upon next sync */
@@ -245,6 +367,37 @@ private:
 	/** Issue a command asynchronously if possible. */
 	ECommandResult::Type IssueCommand(class FGitSourceControlCommand& InCommand, const bool bSynchronous = false );
 
+	/** Remove a state from the category indices, before removing it from the cache or changing its filename */
+	void RemoveStateCategories(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& InState);
+
+	/** Shard of the state cache holding the files with this hash */
+	FGitStateCacheShard& GetStateCacheShard(const uint32 InKeyHash)
+	{
+		return StateCacheShards[InKeyHash >> (32 - GitStateCacheShardBits)];
+	}
+	const FGitStateCacheShard& GetStateCacheShard(const uint32 InKeyHash) const
+	{
+		return StateCacheShards[InKeyHash >> (32 - GitStateCacheShardBits)];
+	}
+
+	/** Copy the references to all the states of the cache, to work on them without holding the locks of the shards */
+	TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> GetAllStatesInternal() const;
+
+	/**
+	 * Delay an asynchronous status update to merge it with the other ones requested for the same repository during a short time
+	 * @returns false if the operation cannot be merged (status history, changelist...)
+	 */
+	bool CoalesceUpdateStatus(const FSourceControlOperationRef& InOperation, const TArray<FString>& InAbsoluteFiles, const FSourceControlOperationComplete& InOperationCompleteDelegate);
+
+	/** Issue the merged status updates once they waited long enough (or now if forced), sharing the results of a queued command if it covers all their files */
+	void IssuePendingUpdateStatuses(const bool bInForce);
+
+	/**
+	 * Remove the files that a queued status update, not started yet, will already update
+	 * @param	OutCommands		The queued status updates covering some of the files: only valid until the next Tick()
+	 */
+	void RemoveFilesOfQueuedUpdateStatuses(const FString& InRepositoryRoot, TArray<FString>& InOutAbsoluteFiles, TArray<class FGitSourceControlCommand*>& OutCommands) const;
+
 	/** Output any messages this command holds */
 	void OutputCommandMessages(const class FGitSourceControlCommand& InCommand) const;
 
@@ -263,11 +416,48 @@ private:
 	/** Git config user.email (from local repository, else globally) */
 	FString UserEmail;
 
+	/** Read again the branch names if the references of the repository changed since they were cached, with RefsCachesCriticalSection unlocked (it is only locked to read and swap the caches) */
+	void UpdateRefsCaches() const;
+
+	/** Critical section for thread safety of the values derived from the references of the repository */
+	mutable FCriticalSection RefsCachesCriticalSection;
+
+	/** Generation of the references of the repository when the branch names were cached (see FGitRefsWatcher) */
+	mutable int32 RefsCachesGeneration = INDEX_NONE;
+
+	/** Incremented when the inputs of the branch names (patterns of the status branches, repository) change, to drop the values read meanwhile */
+	int32 RefsCachesInputsVersion = 0;
+
 	/** Name of the current branch */
-	FString BranchName;
+	mutable FString BranchName;
 
 	/** Name of the current remote branch */
-	FString RemoteBranchName;
+	mutable FString RemoteBranchName;
+
+	/** Remote branches matching the status branch patterns */
+	mutable TArray<FString> StatusBranchNames;
+
+	/** Index of each status branch in StatusBranchNames, for GetStateBranchIndex() */
+	mutable TMap<FString, int32> StatusBranchIndices;
+
+	/** Critical section for thread safety of the acceleration of "git status" */
+	mutable FCriticalSection StatusAccelerationCriticalSection;
+
+	/** Description of the acceleration available in the repository */
+	FString AvailableStatusAcceleration;
+
+	/** Global options in use to accelerate "git status" */
+	FString StatusAccelerationOptions;
+
+	/** Total duration (in seconds) and number of the full statuses of the project directories, without [0] and with [1] acceleration */
+	double FullStatusSeconds[2] = {0.0, 0.0};
+	int32 NumFullStatuses[2] = {0, 0};
+
+	/** Critical section for thread safety of the position of the current branch */
+	mutable FCriticalSection BranchStatusCriticalSection;
+
+	/** Position of the current branch relative to its upstream, for IsAtLatestRevision() */
+	FGitBranchStatus BranchStatus;
 
 	/** URL of the "origin" default remote server */
 	FString RemoteUrl;
@@ -279,15 +469,55 @@ private:
 	FString CommitSummary;
 
 	/** State cache */
-	TMap<FString, TSharedRef<class FGitSourceControlState, ESPMode::ThreadSafe> > StateCache;
+	FGitStateCacheShard StateCacheShards[GitStateCacheShardCount];
+	/** Incremented each time the states of the cache are changed (see GetStateCacheGeneration()) */
+	FThreadSafeCounter StateCacheGeneration;
+	/** Index of the states of the cache by category (see EGitStateCategory), kept up to date by UpdateStateCategories() */
+	TSet<TSharedRef<class FGitSourceControlState, ESPMode::ThreadSafe>, FGitStateCacheKeyFuncs> StateCategoryIndices[EGitStateCategory::Num];
+	/** Reader-writer lock of the category indices, read by worker threads */
+	mutable FRWLock StateCategoryIndicesLock;
 	TMap<FGitSourceControlChangelist, TSharedRef<class FGitSourceControlChangelistState, ESPMode::ThreadSafe> > ChangelistsStateCache;
 
 	/** The currently registered revision control operations */
 	TMap<FName, FGetGitSourceControlWorker> WorkersMap;
 
+	/** The default scheduling priority of each registered operation */
+	TMap<FName, EGitCommandPriority::Type> WorkerPriorities;
+
 	/** Queue for commands given by the main thread */
 	TArray < FGitSourceControlCommand* > CommandQueue;
 
+	/** Commands finished by their worker thread, waiting for Tick() to update the states and call their completion delegate */
+	TArray < FGitSourceControlCommand* > CompletedCommands;
+
+	/** Tells if a command is still queued, running, or waiting for its completion in Tick() */
+	bool IsCommandPending(const FGitSourceControlCommand* InCommand) const
+	{
+		return CommandQueue.Contains(InCommand) || CompletedCommands.Contains(InCommand);
+	}
+
+	/** Find a pending command from its id, or nullptr once Tick() has completed and deleted it */
+	FGitSourceControlCommand* FindPendingCommand(const uint32 InCommandId) const;
+
+	/** Id of the next command issued (see FGitSourceControlCommand::CommandId) */
+	uint32 NextCommandId = 1;
+
+	/** Asynchronous status updates merged together, waiting to be issued as a single command */
+	struct FPendingUpdateStatus
+	{
+		/** Files to update, from all the requests */
+		TSet<FString> Files;
+
+		/** The operations waiting for the results, with their completion delegates */
+		TArray<TPair<FSourceControlOperationRef, FSourceControlOperationComplete>> Waiters;
+
+		/** When the first request was merged */
+		double FirstRequestTime = 0.0;
+	};
+
+	/** Pending status updates, by repository root */
+	TMap<FString, FPendingUpdateStatus> PendingUpdateStatuses;
+
 	/** For notifying when the revision control states in the cache have changed */
 	FSourceControlStateChanged OnSourceControlStateChanged;
 
@@ -297,12 +527,6 @@ private:
 	/** Revision Control Menu Extension */
 	FGitSourceControlMenu GitSourceControlMenu;
 
-	/**
-		Ignore these files when forcing status updates. We add to this list when we've just updated the status already.
-		UE's SourceControl has a habit of performing a double status update, immediately after an operation.
-	*/
-	TArray<FString> IgnoreForceCache;
-
 	/** Array of branch name patterns for status queries */
 	TArray<FString> StatusBranchNamePatternsInternal;
 };
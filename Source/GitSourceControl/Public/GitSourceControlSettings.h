@@ -29,6 +29,15 @@ public:
 	/** Set the username used by the Git LFS 2 File Locks server */
 	bool SetLfsUserName(const FString& InString);
 
+	/** Get the maximum number of Git processes running the batches of a read-only command in parallel (the number of cores if not configured) */
+	int32 GetMaxParallelBatches() const;
+
+	/** Tell if "git status" is accelerated by the file system monitor and the untracked cache, when the repository can use them */
+	bool IsUsingStatusAcceleration() const;
+
+	/** Configure the acceleration of "git status" */
+	bool SetUsingStatusAcceleration(const bool InUsingStatusAcceleration);
+
 	/** Load settings from ini file */
 	void LoadSettings();
 
@@ -47,4 +56,10 @@ private:
 
 	/** Username used by the Git LFS 2 File Locks server */
 	FString LfsUserName;
+
+	/** Tells if "git status" is accelerated by the file system monitor and the untracked cache */
+	bool bUsingStatusAcceleration = false;
+
+	/** Maximum number of Git processes running the batches of a read-only command in parallel (0 for the number of cores, 1 to run them one after the other) */
+	int32 MaxParallelBatches = 0;
 };
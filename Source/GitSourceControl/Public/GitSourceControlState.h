@@ -13,7 +13,7 @@
 /** A consolidation of state priorities. */
 namespace EGitState
 {
-	enum Type
+	enum Type : uint8
 	{
 		Unset,
 		NotAtHead,
@@ -42,7 +42,7 @@ namespace EGitState
 /** Corresponds to diff file states. */
 namespace EFileState
 {
-	enum Type
+	enum Type : uint8
 	{
 		Unset,
 		Unknown,
@@ -59,7 +59,7 @@ namespace EFileState
 /** Where in the world is this file? */
 namespace ETreeState
 {
-	enum Type
+	enum Type : uint8
 	{
 		Unset,
 		/** This file is synced to commit */
@@ -80,7 +80,7 @@ namespace ETreeState
 /** LFS locks status of this file */
 namespace ELockState
 {
-	enum Type
+	enum Type : uint8
 	{
 		Unset,
 		Unknown,
@@ -94,7 +94,7 @@ namespace ELockState
 /** What is this file doing at HEAD? */
 namespace ERemoteState
 {
-	enum Type
+	enum Type : uint8
 	{
 		Unset,
 		/** Up to date */
@@ -113,28 +113,79 @@ namespace ERemoteState
 	};
 }
 
-/** Combined state, for updating cache in a map. */
+/** Categories of the states of the cache, indexed by the provider to answer the common queries without scanning the whole cache */
+namespace EGitStateCategory
+{
+	enum Type : uint8
+	{
+		/** IsModified() */
+		Modified,
+		/** IsAdded() */
+		Added,
+		/** IsDeleted() */
+		Deleted,
+		/** Locked by the current user (only lockable files, unlike IsCheckedOut()) */
+		LockedByMe,
+		/** Locked by someone else: IsCheckedOutOther() */
+		LockedByOther,
+		/** IsConflicted() */
+		Conflicted,
+		/** Newer in the current branch or in a status branch: !IsCurrent() */
+		NotAtHead,
+
+		Num
+	};
+
+	/** Bit of a category, to combine them in a mask */
+	constexpr uint32 Bit(const Type InCategory)
+	{
+		return 1u << InCategory;
+	}
+
+	/** The files with local changes, that can be checked in or reverted */
+	constexpr uint32 LocalChanges = Bit(Modified) | Bit(Added) | Bit(Deleted) | Bit(LockedByMe) | Bit(Conflicted);
+}
+
+/** Combined state, for updating cache in a map. Packed, since one is kept for each file of the project. */
 struct FGitState
 {
 	EFileState::Type FileState = EFileState::Unknown;
 	ETreeState::Type TreeState = ETreeState::NotInRepo;
 	ELockState::Type LockState = ELockState::Unknown;
-	/** Name of user who has locked the file */
-	FString LockUser;
 	ERemoteState::Type RemoteState = ERemoteState::UpToDate;
-	/** The branch with the latest commit for this file */
+	/** Name of user who has locked the file (case-sensitive, so not an FName; usually empty) */
+	FString LockUser;
+	/** The branch with the latest commit for this file (case-sensitive, so not an FName; usually empty) */
 	FString HeadBranch;
 };
 
+/** Details of a file that are rarely set: only allocated when they differ from their defaults. */
+struct FGitStateDetails
+{
+#if !UE_VERSION_OLDER_THAN(5, 3, 0)
+	/** Pending rev info with which a file must be resolved, invalid if no resolve pending */
+	ISourceControlState::FResolveInfo PendingResolveInfo;
+#else
+	/** File Id with which our local revision diverged from the remote revision */
+	FString PendingMergeBaseFileHash;
+#endif
+
+	/** The action within the head branch TODO */
+	FString HeadAction = TEXT("Changed");
+
+	/** The last file modification time in the head branch TODO */
+	int64 HeadModTime = 0;
+
+	/** The change list the last modification TODO */
+	FString HeadCommit = TEXT("Unknown");
+};
+
 class GITSOURCECONTROL_API FGitSourceControlState : public ISourceControlState
 {
 public:
     explicit FGitSourceControlState(const FString &InLocalFilename) :
         LocalFilename( InLocalFilename ),
-        TimeStamp( 0 ),
-        HeadAction( TEXT( "Changed" ) ),
-        HeadModTime( 0 ),
-        HeadCommit( TEXT( "Unknown" ) )
+        TimeStamp( 0 )
     {
     }
 
@@ -184,6 +235,24 @@ public:
 	virtual bool IsConflicted() const override;
 	virtual bool CanRevert() const override;
 
+	/** Details of the file, or their defaults if they were never set */
+	const FGitStateDetails& GetDetails() const;
+
+	/** Mask of the categories of the file (see EGitStateCategory) */
+	uint32 GetCategories() const;
+
+	/** Tells if some details of the file were set */
+	bool HasDetails() const
+	{
+		return Details.IsValid();
+	}
+
+	/** Details of the file to modify, allocated on first use (and copied if shared with a copy of this state) */
+	FGitStateDetails& MutableDetails();
+
+	/** Memory allocated on the heap for this state, for the memory report of the state cache */
+	SIZE_T GetAllocatedSize() const;
+
 private:
 	EGitState::Type GetGitState() const;
 
@@ -194,14 +263,6 @@ public:
 	/** Filename on disk */
 	FString LocalFilename;
 
-#if !UE_VERSION_OLDER_THAN(5, 3, 0)
-	/** Pending rev info with which a file must be resolved, invalid if no resolve pending */
-	FResolveInfo PendingResolveInfo;
-#else
-	/** File Id with which our local revision diverged from the remote revision */
-	FString PendingMergeBaseFileHash;
-#endif
-
 	/** Status of the file */
 	FGitState State;
 
@@ -210,12 +271,13 @@ public:
 	/** The timestamp of the last update */
 	FDateTime TimeStamp;
 
-	/** The action within the head branch TODO */
-	FString HeadAction;
+	/** The status has just been updated: ignore the next forced status update (see FGitSourceControlProvider::AddFileToIgnoreForceCache()) */
+	bool bIgnoreForceUpdate = false;
 
-	/** The last file modification time in the head branch TODO */
-	int64 HeadModTime;
+	/** Mask of the categories under which the file is indexed by the provider (see FGitSourceControlProvider::UpdateStateCategories()) */
+	uint8 IndexedCategories = 0;
 
-	/** The change list the last modification TODO */
-	FString HeadCommit;
+private:
+	/** Rarely set details (see GetDetails()), shared between copies of the state until modified */
+	TSharedPtr<FGitStateDetails, ESPMode::ThreadSafe> Details;
 };
@@ -23,6 +23,9 @@ public:
 	/** Constructor - open & write string to temp file */
 	FGitScopedTempFile(const FText& InText);
 
+	/** Constructor - open & write a list of NUL-terminated paths to temp file (for "--pathspec-from-file" with "--pathspec-file-nul") */
+	FGitScopedTempFile(const TArray<FString>& InFiles);
+
 	/** Destructor - delete temp file */
 	~FGitScopedTempFile();
 
@@ -35,6 +38,7 @@ private:
 };
 
 struct FGitVersion;
+struct FGitBranchStatus;
 
 class FGitLockedFilesCache
 {
@@ -52,6 +56,22 @@ private:
 	static TMap<FString, FString> LockedFiles;
 };
 
+/**
+ * New states of files resolved in the cache and compared to it on the worker thread of a command (see GitSourceControlUtils::PrepareCachedStates()),
+ * so that applying them on the main thread only has to touch the states that changed.
+ */
+struct FGitCachedStatesUpdate
+{
+	/** The states of the cache with their new status, the ones that changed first */
+	TArray<TPair<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>, FGitState>> States;
+
+	/** Number of states at the start of States that differed from the cache when compared */
+	int32 NumChanged = 0;
+
+	/** Generation of the state cache when compared: if it changed since then, all the states are applied */
+	int32 Generation = INDEX_NONE;
+};
+
 namespace GitSourceControlUtils
 {
 	/**
@@ -100,6 +120,19 @@ bool CheckGitAvailability(const FString& InPathToGitBinary, FGitVersion* OutVers
 		*/
 	void FindGitCapabilities(const FString& InPathToGitBinary, FGitVersion* OutVersion);
 
+	/**
+		* Find how "git status" can be accelerated in a repository: the builtin file system monitor daemon (Windows and macOS),
+		* else a "fsmonitor-watchman" hook installed in the repository (Linux), and the untracked cache.
+		* The ones configured in the repository (enabled or not) are left alone.
+		* @param InPathToGitBinary		The path to the Git binary
+		* @param InRepositoryRoot		The Git repository
+		* @param InVersion				The version and capabilities of Git (see FindGitCapabilities())
+		* @param bInInstallHook			Install the "fsmonitor-watchman" hook from its sample if Watchman is in the PATH
+		* @param OutOptions				Global options to give to Git commands, like "-c core.fsmonitor=true -c core.untrackedCache=true " (empty if none)
+		* @param OutDescription			Human readable list of the available acceleration, or why there is none and how to enable it
+		*/
+	void FindStatusAcceleration(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FGitVersion& InVersion, const bool bInInstallHook, FString& OutOptions, FString& OutDescription);
+
 	/**
 		* Run a Git "lfs" command to check the availability of the "Large File System" extension.
 		* @param InPathToGitBinary		The path to the Git binary
@@ -115,6 +148,14 @@ bool CheckGitAvailability(const FString& InPathToGitBinary, FGitVersion* OutVers
  */
 bool FindRootDirectory(const FString& InPath, FString& OutRepositoryRoot);
 
+/**
+ * Find the Git directory of a repository: the ".git" subdirectory, or the directory a ".git" file points to (for a worktree or a submodule)
+ * @param InRepositoryRoot		The path to the root directory of the Git repository
+ * @param OutGitDirectory		The path to the Git directory, containing the index, the HEAD and the refs of the working tree
+ * @returns true if the Git directory was found
+ */
+bool FindGitDirectory(const FString& InRepositoryRoot, FString& OutGitDirectory);
+
 /**
  * Get Git config user.name & user.email
  * @param	InPathToGitBinary	The path to the Git binary
@@ -125,7 +166,7 @@ bool FindRootDirectory(const FString& InPath, FString& OutRepositoryRoot);
 void GetUserConfig(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail);
 
 /**
- * Get Git current checked-out branch
+ * Get Git current checked-out branch, as cached by the provider until the references of the repository change
  * @param	InPathToGitBinary	The path to the Git binary
  * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
  * @param	OutBranchName		Name of the current checked-out branch (if any, ie. not in detached HEAD)
@@ -134,11 +175,23 @@ void GetUserConfig(const FString& InPathToGitBinary, const FString& InRepository
 bool GetBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName);
 
 /**
- * Get Git remote tracking branch
+ * Get Git remote tracking branch, as cached by the provider until the references of the repository change
  * @returns false if the branch is not tracking a remote
  */
 bool GetRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName);
 
+/**
+ * Read Git current checked-out branch from the repository, bypassing the cache of the provider
+ * @see GetBranchName()
+ */
+bool ReadBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName);
+
+/**
+ * Read Git remote tracking branch from the repository, bypassing the cache of the provider
+ * @see GetRemoteBranchName()
+ */
+bool ReadRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName);
+
  /**
  * Get Git remote tracking branches that match wildcard
  * @returns false if no matching branches
@@ -164,6 +217,15 @@ bool GetCommitInfo(const FString& InPathToGitBinary, const FString& InRepository
  */
 bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutRemoteUrl);
 
+/**
+ * Get the executable to launch for a Git command line (the Git binary itself, or an environment wrapper for it on Mac).
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InOutFullCommand	The full Git command line, updated if the Git binary needs to be wrapped
+ * @returns the path to the executable to launch with the command line
+ */
+FString GetGitLaunchExecutable(const FString& InPathToGitBinary, FString& InOutFullCommand);
+
 /**
  * Run a Git command - output is a string TArray.
  *
@@ -177,6 +239,25 @@ bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryR
  * @returns true if the command succeeded and returned no errors
  */
 GITSOURCECONTROL_API  bool RunCommand( const FString & InCommand, const FString & InPathToGitBinary, const FString & InRepositoryRoot, const TArray< FString > & InParameters, const TArray< FString > & InFiles, TArray< FString > & OutResults, TArray< FString > & OutErrorMessages );
+
+/**
+ * Run a Git command - output is handed to a callback record per record (line per line by default), while the command is still running.
+ *
+ * Avoid buffering the whole output of commands listing a lot of files (status, ls-files, log...)
+ *
+ * @param	InCommand			The Git command - e.g. status
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory (can be empty)
+ * @param	InParameters		The parameters to the Git command
+ * @param	InFiles				The files to be operated on
+ * @param	InOnRecord			Called for each non-empty record of the output (from StdOut), in order
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @param	InDelimiter			The delimiter of the records: '\n' for lines, or '\0' for the -z output format of Git commands
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunCommandStreaming(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles,
+						 const TFunctionRef<void(FStringView)>& InOnRecord, TArray<FString>& OutErrorMessages, const ANSICHAR InDelimiter = '\n');
+
 bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const int32 ExpectedReturnCode = 0);
 
 /**
@@ -242,10 +323,26 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
  * @param	InFiles				The files to be operated on
  * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
  * @param   OutStates           The resultant states
+ * @param	OutBranchStatus		If provided, the position of the current branch relative to its upstream (with "--porcelain=v2 --branch")
  * @returns true if the command succeeded and returned no errors
  */
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking, const TArray<FString>& InFiles,
-					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates);
+					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates, FGitBranchStatus* OutBranchStatus = nullptr);
+
+/**
+ * Run a Git "status" command on the project directories (Content/, Config/ and the project file) and parse it.
+ * Only the paths changed since the last one are given to Git when the working tree is watched (see FGitWorkingTreeWatcher):
+ * the states of the other files in the cache are then still up to date.
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory (can be empty)
+ * @param	InUsingLfsLocking	Tells if using the Git LFS file Locking workflow
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @param   OutStates           The resultant states
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunUpdateStatusOfProject(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking,
+							  TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates);
 	
 /**
  * Keep Consistency of being file staged
@@ -273,11 +370,9 @@ bool UpdateFileStagingOnSavedInternal(const FString& Filename);
 void UpdateStateOnAssetRename(const FAssetData& InAssetData, const FString& InOldName);
 	
 /**
- * 
+ * Rebuild the Staged and Working changelists from a full status of the Content directory.
  *
- * @param	Filename			Saved filename
- * @param	Pkg					Package (for adapting delegate)
- * @param   ObjectSaveContext	Context for save (for adapting delegate)
+ * Only needed for an explicit full refresh: UpdateCachedStates() already keeps the changelists up to date with each status update.
  */
 bool UpdateChangelistStateByCommand();
 	
@@ -334,6 +429,20 @@ void RemoveRedundantErrors(FGitSourceControlCommand& InCommand, const FString& I
  */
 GITSOURCECONTROL_API bool UpdateCachedStates( const TMap< const FString, FGitState > & InResults );
 
+/**
+ * Resolve the new states of files in the cache and compare them to it, to be applied later on the main thread (thread-safe)
+ * @param	InResults		The new states of the files
+ * @param	OutUpdate		The states of the cache and their new status, to give to UpdateCachedStates()
+ * @returns true if there are any states to update
+ */
+GITSOURCECONTROL_API bool PrepareCachedStates(const TMap<const FString, FGitState>& InResults, FGitCachedStatesUpdate& OutUpdate);
+
+/**
+ * Apply the new states prepared by PrepareCachedStates() to the cache (main thread)
+ * @returns true if any states were changed
+ */
+GITSOURCECONTROL_API bool UpdateCachedStates(const FGitCachedStatesUpdate& InUpdate);
+
 /**
 * Helper function for various commands to collect new states.
 * @returns true if any states were updated
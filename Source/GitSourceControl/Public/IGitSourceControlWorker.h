@@ -7,6 +7,22 @@
 
 #include "Templates/SharedPointer.h"
 
+/** Scheduling priority of a revision control command, from the most to the least urgent */
+namespace EGitCommandPriority
+{
+	enum Type : uint8
+	{
+		/** The user waits for it to keep on working (check-out, revert, mark for add...) */
+		Interactive,
+		/** Requested by the user or by the Editor UI, but the user can keep working meanwhile (status of some assets, sync...) */
+		Foreground,
+		/** Maintenance work (fetch, status of the whole working copy, changelists refresh), yielding to the other commands between batches of files */
+		Background,
+
+		Num
+	};
+}
+
 class IGitSourceControlWorker
 {
 public:
@@ -21,6 +37,11 @@ public:
 	 */
 	virtual bool Execute( class FGitSourceControlCommand& InCommand ) = 0;
 
+	/**
+	 * Prepares the update of the states after Execute(), on the same thread, so that UpdateStates() only has the changed states to apply.
+	 */
+	virtual void PrepareStates() {}
+
 	/**
 	 * Updates the state of any items after completion (if necessary). This is always executed on the main thread.
 	 * @returns true if states were updated